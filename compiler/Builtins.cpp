@@ -4,24 +4,29 @@
 #include "Builtins.h"
 #include "LLVMUtils.h"
 #include "LLVMBackend.h"
+#include "../linking/Format.h"
 #include <llvm/IR/IRBuilder.h>
 
 BuiltinFunctionResolver::BuiltinFunctionResolver() {
     auto bf = new BuiltinFunction("println",
                                   {
-                                          new RocAnyType()
+                                          TypeTable::anyType()
                                   },
-                                  new UnitRocType());
-    addFunction(bf);
+                                  TypeTable::unitType());
+    bf->retainsArguments = false; //arguments are written out and forgotten
+    addFunction(roc::symbols::printlnName, bf);
 
     bf = new BuiltinFunction("ccall",
                                   {
-                                          new RocRawStringType(-1),
-                                          new RocAnyType()
+                                          TypeTable::rawStringType(-1),
+                                          TypeTable::anyType()
                                   },
-                                  new RocAnyType(),
+                                  TypeTable::anyType(),
                                   true);
-    addFunction(bf);
+    addFunction(roc::symbols::ccallName, bf);
+
+    bf = new BuiltinFunction("flush", {}, TypeTable::unitType());
+    addFunction(roc::symbols::flushName, bf);
 }
 
 void defineAnyType(RocLLVMContext *rocLlvmContext) {
@@ -90,8 +95,7 @@ void defineIntType(RocLLVMContext *rocLlvmContext) {
     }, "Int32Type");
     rocLlvmContext->int32StructType = int32StructType;
 
-    auto int32Type = std::make_unique<RocInt32Type>();
-    createGetTypeIdFunction(rocLlvmContext, int32Type.get());
+    createGetTypeIdFunction(rocLlvmContext, TypeTable::int32Type());
 
     auto toStringFunType = FunctionType::get(rocLlvmContext->stringRawType->getPointerTo(), {
             PointerType::get(int32StructType, 0),
@@ -107,19 +111,23 @@ void defineIntType(RocLLVMContext *rocLlvmContext) {
     auto *mallocFunType = FunctionType::get(Type::getInt8PtrTy(*llvmContext), {
             Type::getInt64Ty(*llvmContext),
     }, false);
-    auto mallocFun = module->getOrInsertFunction("malloc", mallocFunType);
-    auto *charArray = Builder.CreateCall(mallocFun, {ConstantInt::get(Type::getInt64Ty(*llvmContext), 12)},
-                                         "call-malloc");
-
+    auto mallocFun = module->getOrInsertFunction("rocAlloc", mallocFunType);
+    //header and chars are a single block like in myInt32ToString, so myDecr releases both
     auto *stringStructAllocation = Builder.CreateCall(mallocFun, {
-            ConstantInt::get(Type::getInt64Ty(*llvmContext), 36)
+            ConstantExpr::getAdd(ConstantExpr::getSizeOf(rocLlvmContext->stringRawType),
+                                 ConstantInt::get(Type::getInt64Ty(*llvmContext), ROC_INT32_MAX_CHARS + 1))
     }, "call-malloc-for-string-struct");
     auto *stringStructReference = BitCastInst::Create(Instruction::BitCast,
                                                       stringStructAllocation,
                                                       rocLlvmContext->stringRawType->getPointerTo(),
                                                       "struct-struct-ref",
                                                       entry);
-
+    auto *charArray = Builder.CreateBitCast(Builder.CreateConstGEP1_64(rocLlvmContext->stringRawType,
+                                                                       stringStructReference,
+                                                                       1,
+                                                                       "string-chars"),
+                                            Type::getInt8PtrTy(*llvmContext),
+                                            "string-chars-ref");
 
     std::vector<Value *> gep1Args;
     gep1Args.push_back(ConstantInt::get(Type::getInt64Ty(*llvmContext), 0));
@@ -129,35 +137,30 @@ void defineIntType(RocLLVMContext *rocLlvmContext) {
                                           gep1Args,
                                           "gep1", entry);
     auto *loadInst = new LoadInst(rocLlvmContext->int32Type, gep1, "get-int32-value", entry);
-    auto *sprintfFT = FunctionType::get(Type::getInt32Ty(*llvmContext), {
+    auto *formatFT = FunctionType::get(Type::getInt32Ty(*llvmContext), {
             Type::getInt8PtrTy(*llvmContext),
+            rocLlvmContext->int32Type,
+    }, false);
+    auto formatFun = module->getOrInsertFunction("rocFormatInt32", formatFT);
+    auto *stringLength = Builder.CreateCall(formatFun, {charArray, loadInst}, "call-format");
+    //rocFormatInt32 writes at most ROC_INT32_MAX_CHARS chars, the byte after them terminates the content
+    auto *end = Builder.CreateGEP(rocLlvmContext->int8Type, charArray, stringLength, "string-end");
+    Builder.CreateStore(ConstantInt::get(rocLlvmContext->int8Type, 0), end);
+
+    //sets header (vtable, type id, ref counter), content and length of the result
+    auto *initRawStringFT = FunctionType::get(Type::getVoidTy(*llvmContext), {
+            rocLlvmContext->stringRawType->getPointerTo(),
             Type::getInt8PtrTy(*llvmContext),
             rocLlvmContext->int32Type,
+            rocLlvmContext->int64Type,
     }, false);
-    auto sprintfFun = module->getOrInsertFunction("myIntToString", sprintfFT);
-    auto dFormatString = Builder.CreateGlobalStringPtr("%d");
-    auto *stringLength = Builder.CreateCall(sprintfFun, {charArray, dFormatString, loadInst}, "call-sprintf");
-
-    std::vector<Value *> gepArgs;
-    gepArgs.push_back(ConstantInt::get(Type::getInt64Ty(*llvmContext), 24));
-    auto *charArrayGep = GetElementPtrInst::Create(Type::getInt8Ty(*llvmContext),
-                                                   stringStructAllocation,
-                                                   gepArgs,
-                                                   "charArrayGep", entry);
-    auto *charArrayGepCast = BitCastInst::Create(Instruction::BitCast, charArrayGep,
-                                                 Type::getInt8PtrTy(*llvmContext)->getPointerTo(), "", entry);
-    new StoreInst(charArray, charArrayGepCast, false, entry);
-
-
-    std::vector<Value *> gepArgs2;
-    gepArgs2.push_back(ConstantInt::get(Type::getInt64Ty(*llvmContext), 32));
-    auto *lengthGep = GetElementPtrInst::Create(Type::getInt8Ty(*llvmContext),
-                                                stringStructAllocation,
-                                                gepArgs2,
-                                                "lengthGep", entry);
-    auto *lengthGepCast = BitCastInst::Create(Instruction::BitCast, lengthGep,
-                                              Type::getInt32Ty(*llvmContext)->getPointerTo(), "", entry);
-    new StoreInst(stringLength, lengthGepCast, false, entry);
+    auto initRawStringFun = module->getOrInsertFunction("myInitRawString", initRawStringFT);
+    Builder.CreateCall(initRawStringFun, {
+            stringStructReference,
+            charArray,
+            stringLength,
+            getVTableAddress(rocLlvmContext, TypeTable::rawStringType(-1))
+    });
 
     ReturnInst::Create(*llvmContext, stringStructReference, entry);
 }
@@ -215,6 +218,25 @@ void definePrint(RocLLVMContext *rocLlvmContext) {
     ReturnInst::Create(*llvmContext, entry);
 }
 
+/**
+ * Defines flush() function, writes output buffered by the runtime
+ */
+void defineFlush(RocLLVMContext *rocLlvmContext) {
+    auto *module = rocLlvmContext->module;
+    auto *llvmContext = rocLlvmContext->llvmContext;
+    auto *flushFT = FunctionType::get(Type::getVoidTy(*llvmContext), {}, false);
+    auto *flushF = Function::Create(flushFT, Function::ExternalLinkage, "flush", module);
+
+    IRBuilder<> Builder(*llvmContext);
+    BasicBlock *entry = BasicBlock::Create(*llvmContext, "entrypoint", flushF);
+    Builder.SetInsertPoint(entry);
+
+    auto f = module->getOrInsertFunction("rocFlush", flushFT);
+    Builder.CreateCall(f, {}, "");
+
+    ReturnInst::Create(*llvmContext, entry);
+}
+
 /**
  * Creates call to int32ToString(int n) function
  */
@@ -235,10 +257,12 @@ void defineInt32ToStringRaw(RocLLVMContext *rocLlvmContext) {
 
     auto *ft = FunctionType::get(Type::getInt64Ty(*llvmContext), {
             Type::getInt32Ty(*llvmContext),
+            Type::getInt64Ty(*llvmContext),
     }, false);
     auto f = module->getOrInsertFunction("myInt32ToString", ft);
     auto result = Builder.CreateCall(f, {
             int32ToStringF->getArg(0),
+            getVTableAddress(rocLlvmContext, TypeTable::rawStringType(-1)),
     }, "");
 
     auto ptr = CastInst::Create(llvm::Instruction::IntToPtr, result, rocLlvmContext->stringRawType->getPointerTo(),
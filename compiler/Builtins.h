@@ -7,12 +7,14 @@
 
 #include "../mir/MIR.h"
 #include <map>
+#include <unordered_map>
 #include <string>
 
 class RocLLVMContext;
 
 void definePrintln(RocLLVMContext *rocLlvmContext);
 void definePrint(RocLLVMContext *rocLlvmContext);
+void defineFlush(RocLLVMContext *rocLlvmContext);
 
 void defineInt32ToStringRaw(RocLLVMContext *rocLlvmContext);
 
@@ -30,14 +32,15 @@ void createAnyToString(RocLLVMContext *rocLlvmContext);
 class BuiltinFunction : public TargetFunctionCall {
 public:
     std::string name;
-    std::vector<std::unique_ptr<RocType>> typeParameters;
-    std::vector<std::unique_ptr<RocType>> parameters;
-    std::unique_ptr<RocType> returnType;
+    std::vector<RocType*> typeParameters;
+    std::vector<RocType*> parameters;
+    RocType* returnType;
     bool varArgs = false;
+    bool retainsArguments = true; //see keepsArguments()
 
     explicit BuiltinFunction(std::string name) {
         this->name = std::move(name);
-        this->returnType = std::make_unique<UnitRocType>();
+        this->returnType = TypeTable::unitType();
     }
 
     explicit BuiltinFunction(std::string name,
@@ -45,10 +48,8 @@ public:
                              RocType* returnType,
                              bool varArgs = false) {
         this->name = std::move(name);
-        for (auto& p: parameters) {
-            this->parameters.push_back(std::unique_ptr<RocType>(p));
-        }
-        this->returnType = std::unique_ptr<RocType>(returnType);
+        this->parameters = parameters;
+        this->returnType = returnType;
         this->varArgs = varArgs;
     }
 
@@ -57,17 +58,13 @@ public:
                              const std::vector<RocType*>& parameters,
                              RocType* returnType) {
         this->name = std::move(name);
-        for (auto& p: typeParameters) {
-            this->typeParameters.push_back(std::unique_ptr<RocType>(p));
-        }
-        for (auto& p: parameters) {
-            this->parameters.push_back(std::unique_ptr<RocType>(p));
-        }
-        this->returnType = std::unique_ptr<RocType>(returnType);
+        this->typeParameters = typeParameters;
+        this->parameters = parameters;
+        this->returnType = returnType;
     }
 
     RocType * getReturnType() override {
-        return this->returnType.get();
+        return this->returnType;
     }
 
     std::string getName() override {
@@ -75,11 +72,11 @@ public:
     }
 
     std::vector<RocType *> getArgumentTypes() override {
-        std::vector<RocType*> result;
-        for (auto& p : this->parameters) {
-            result.push_back(p.get());
-        }
-        return result;
+        return this->parameters;
+    }
+
+    bool keepsArguments() override {
+        return retainsArguments;
     }
 };
 
@@ -88,19 +85,15 @@ public:
  */
 class BuiltinFunctionResolver : public MIRVisitor {
 public:
-    std::map<std::string, std::vector<std::unique_ptr<BuiltinFunction>>> functions;
+    std::unordered_map<SymbolId, std::vector<std::unique_ptr<BuiltinFunction>>> functions;
 
     BuiltinFunctionResolver();
 
-    void addFunction(BuiltinFunction* function) {
-        auto it = functions.find(function->name);
-        if (it == functions.end()) {
-            std::vector<std::unique_ptr<BuiltinFunction>> f;
-            f.push_back(std::unique_ptr<BuiltinFunction>(function));
-            functions.insert({function->name, std::move(f)});
-        } else {
-            it->second.push_back(std::unique_ptr<BuiltinFunction>(function));
-        }
+    /**
+     * @param symbol well known symbol of the function name (see roc::symbols)
+     */
+    void addFunction(SymbolId symbol, BuiltinFunction* function) {
+        functions[symbol].push_back(std::unique_ptr<BuiltinFunction>(function));
     }
 };
 
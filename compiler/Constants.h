@@ -11,7 +11,7 @@ namespace roc {
 
     namespace methods {
 
-        //method ids
+        //method ids, used as slot indices of virtual tables (see ROC_VTABLE_SIZE in API.h)
         static long long toStringMethodId = 0;
         static long long typeIdMethodId = 1;
         static long long hashCodeMethodId = 2;
@@ -26,11 +26,11 @@ public:
     }
 
     std::vector<RocType *> getArgumentTypes() override {
-        return ((RocFunctionContext*) functionDeclaration->getContextHolder("typeContext"))->parameterTypes;
+        return ((RocFunctionContext*) functionDeclaration->getContextHolder(TYPE_CONTEXT))->parameterTypes;
     }
 
     RocType *getReturnType() override {
-        return ((RocFunctionContext*) functionDeclaration->getContextHolder("typeContext"))->returnType;
+        return ((RocFunctionContext*) functionDeclaration->getContextHolder(TYPE_CONTEXT))->returnType;
     }
 };
 
@@ -39,11 +39,12 @@ public:
  */
 class PredefinedTargetMethodCall : public TargetFunctionCall {
 public:
-    std::unique_ptr<RocType> owner;
+    RocType* owner;
     std::string name;
     std::string realName;
-    std::vector<std::unique_ptr<RocType>> argTypes;
-    std::unique_ptr<RocType> returnType;
+    std::vector<RocType*> argTypes;
+    RocType* returnType;
+    bool newObject = false; //see returnsNewObject()
 
     PredefinedTargetMethodCall(RocType* owner,
                                std::string name,
@@ -51,13 +52,11 @@ public:
                                const std::vector<RocType*>& argTypes,
                                RocType* returnType) {
 
-        this->owner = std::unique_ptr<RocType>(owner);
+        this->owner = owner;
         this->name = std::move(name);
         this->realName = std::move(realName);
-        for (auto& rc: argTypes) {
-            this->argTypes.push_back(std::unique_ptr<RocType>(rc));
-        }
-        this->returnType = std::unique_ptr<RocType>(returnType);
+        this->argTypes = argTypes;
+        this->returnType = returnType;
     }
 
     std::string getName() override {
@@ -69,15 +68,15 @@ public:
     }
 
     std::vector<RocType *> getArgumentTypes() override {
-        std::vector<RocType*> result;
-        for (auto& rc: argTypes) {
-            result.push_back(rc.get());
-        }
-        return result;
+        return argTypes;
     }
 
     RocType *getReturnType() override {
-        return returnType.get();
+        return returnType;
+    }
+
+    bool returnsNewObject() override {
+        return newObject;
     }
 };
 
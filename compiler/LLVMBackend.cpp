@@ -19,6 +19,7 @@
 #include "llvm/IR/Type.h"
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/raw_ostream.h"
 #include <llvm/IR/IRBuilder.h>
 #include "llvm/Support/raw_ostream.h"
@@ -57,6 +58,7 @@ void ToLLVMVisitor::visit(MIRModule *mirModule) {
     createAnyToString(this->rocLLVMContext);
     definePrintln(this->rocLLVMContext);
     definePrint(this->rocLLVMContext);
+    defineFlush(this->rocLLVMContext);
 
     defineInt32ToStringRaw(this->rocLLVMContext);
 
@@ -98,35 +100,39 @@ void ToLLVMVisitor::visit(MIRModule *mirModule) {
 }
 
 void ToLLVMVisitor::visit(MIRFunction *mirFunction) {
+    llvm::TimeTraceScope traceScope("to LLVM", mirFunction->name);
     this->compilationFunctionStack.push_back(mirFunction);
     int i = 0;
     for (auto &p: mirFunction->parameters) {
         mirFunction->localsMap.insert({i, this->compilationFunctionStack.back()->llvmFunction->getArg(i)});
         i++;
     }
-    mirFunction->body->accept(this);
+    //every MIR basic block maps to exactly one LLVM basic block
+    for (auto &block: mirFunction->blocks) {
+        block->llvmBlock = BasicBlock::Create(*this->llvmContext, block->name, mirFunction->llvmFunction);
+    }
+    for (auto &block: mirFunction->blocks) {
+        block->accept(this);
+    }
     this->compilationFunctionStack.pop_back();
 }
 
-void ToLLVMVisitor::visit(MIRBlock *mirBlock) {
-    if (!mirBlock->blockInitialized) {
-        this->currentBlock = BasicBlock::Create(*this->llvmContext,
-                                                mirBlock->name,
-                                                this->compilationFunctionStack.back()->llvmFunction);
-    }
-
-    if (this->compilationFunctionStack.back()->llvmFunction->getName() == "main") {
-        auto initFT1 = FunctionType::get(this->rocLLVMContext->int64Type, {}, false);
-        auto initF1 = module->getOrInsertFunction("Int32.vtable.init", initFT1);
-        CallInst::Create(initF1, {}, "", this->currentBlock);
+void ToLLVMVisitor::visit(MIRBasicBlock *mirBasicBlock) {
+    this->currentBlock = mirBasicBlock->llvmBlock;
 
-        auto initFT2 = FunctionType::get(this->rocLLVMContext->int64Type, {}, false);
-        auto initF2 = module->getOrInsertFunction("StringRaw.vtable.init", initFT2);
-        CallInst::Create(initF2, {}, "", this->currentBlock);
-    }
-    for (auto &expr: mirBlock->values) {
+    for (auto &expr: mirBasicBlock->values) {
         expr->accept(this);
     }
+
+    if (mirBasicBlock->condition) {
+        mirBasicBlock->condition->accept(this);
+        BranchInst::Create(mirBasicBlock->successors[0]->llvmBlock,
+                           mirBasicBlock->successors[1]->llvmBlock,
+                           this->popLast(),
+                           this->currentBlock);
+    } else if (mirBasicBlock->successors.size() == 1) {
+        BranchInst::Create(mirBasicBlock->successors[0]->llvmBlock, this->currentBlock);
+    }
 }
 
 void ToLLVMVisitor::visit(MIRFunctionInstanceCall *mirFunctionCall) {
@@ -135,31 +141,40 @@ void ToLLVMVisitor::visit(MIRFunctionInstanceCall *mirFunctionCall) {
         arg->accept(this);
     }
     //instance call transformed to function call where 1st argument is the calling ref
-    std::vector<Value *> values(mirFunctionCall->arguments.size() + 1);
+    auto numberOfArguments = mirFunctionCall->arguments.size();
+    std::vector<Value *> values(numberOfArguments + 1);
+    for (int i = 0; i < numberOfArguments; ++i) {
+        values[numberOfArguments - i] = this->valueStack.back();
+        this->valueStack.pop_back();
+    }
     auto callerRef = this->valueStack.back();
     this->valueStack.pop_back();
     values[0] = callerRef;
-    for (int i = 1; i < mirFunctionCall->arguments.size(); ++i) {
-        values[1 + mirFunctionCall->arguments.size() - i] = this->valueStack.back();
-        this->valueStack.pop_back();
-    }
+
     auto *cast = BitCastInst::Create(Instruction::BitCast,
                                      callerRef,
                                      this->rocLLVMContext->anyTypeStructType->getPointerTo(),
                                      "cast-to-any",
                                      this->currentBlock);
-    auto f = this->module->getOrInsertFunction("myGetFunctionPointer", FunctionType::get(rocLLVMContext->int64Type, {
-            rocLLVMContext->anyTypeStructType->getPointerTo(),
-            rocLLVMContext->int64Type
-    }, false));
-    //call instance method
-    auto vtableMap = CallInst::Create(f,
-                                      {
-                                              cast, ConstantInt::get(rocLLVMContext->int64Type,
-                                                                          roc::methods::getMethodId(
-                                                                                  mirFunctionCall->name))},
-                                      "call-myGetFunctionPointer",
+    //vtable is a flat array of function pointers indexed by method id
+    auto *vTable = getFieldFromStruct(this->llvmContext,
+                                      this->rocLLVMContext->anyTypeStructType,
+                                      cast,
+                                      0,
+                                      this->rocLLVMContext->int64Type,
                                       this->currentBlock);
+    auto *vTableSlots = CastInst::Create(llvm::Instruction::IntToPtr,
+                                         vTable,
+                                         this->rocLLVMContext->int64Type->getPointerTo(),
+                                         "vtable",
+                                         this->currentBlock);
+    auto *slot = GetElementPtrInst::Create(this->rocLLVMContext->int64Type,
+                                           vTableSlots,
+                                           { ConstantInt::get(rocLLVMContext->int64Type,
+                                                              roc::methods::getMethodId(mirFunctionCall->name)) },
+                                           "vtable-slot",
+                                           this->currentBlock);
+    auto *functionPointer = new LoadInst(this->rocLLVMContext->int64Type, slot, "", this->currentBlock);
 
     std::vector<Type *> argumentTypes;
     auto callerType = mirFunctionCall->caller->getType();
@@ -178,15 +193,15 @@ void ToLLVMVisitor::visit(MIRFunctionInstanceCall *mirFunctionCall) {
             mirFunctionCall->getTargetCall()->getReturnType()->getLLVMType(this->rocLLVMContext),
             argumentTypes, false);
     auto ptr = CastInst::Create(llvm::Instruction::IntToPtr,
-                                vtableMap,
+                                functionPointer,
                                 ft->getPointerTo(),
                                 "",
                                 this->currentBlock);
     auto value = CallInst::Create(ft,
                                   ptr,
                                   values,
-                                  mirFunctionCall->getTargetCall()->getRealName(), this->currentBlock);
-    this->valueStack.pop_back();
+                                  ft->getReturnType()->isVoidTy() ? "" : mirFunctionCall->getTargetCall()->getRealName(),
+                                  this->currentBlock);
 
     if (!ft->getReturnType()->isVoidTy()) {
         this->valueStack.push_back(value);
@@ -232,6 +247,16 @@ void ToLLVMVisitor::visit(MIRFunctionCall *mirFunctionCall) {
                                   name,
                                   this->currentBlock);
 
+    //new objects passed to a function that does not keep them are released right after the call
+    auto targetCall = mirFunctionCall->getTargetCall();
+    if (targetCall && !targetCall->keepsArguments()) {
+        for (int i = 0; i < numberOfArguments; ++i) {
+            if (mirFunctionCall->arguments[i]->isNewObject()) {
+                releaseObject(this, values[i]);
+            }
+        }
+    }
+
     if (!ft->getReturnType()->isVoidTy()) {
         this->valueStack.push_back(value);
     }
@@ -562,33 +587,6 @@ void ToLLVMVisitor::visitFalse(MIRFalse *mirFalse) {
     this->valueStack.push_back(ConstantInt::get(Type::getInt1Ty(*this->llvmContext), 0));
 }
 
-void ToLLVMVisitor::visitIf(MIRIf *mirIf) {
-    mirIf->condition->accept(this);
-    auto condition = this->valueStack.back();
-    this->valueStack.pop_back();
-    auto *startBlock = BasicBlock::Create(*this->llvmContext,
-                                          "if-start",
-                                          this->compilationFunctionStack.back()->llvmFunction);
-    auto *endBlock = BasicBlock::Create(*this->llvmContext,
-                                        "if-end",
-                                        this->compilationFunctionStack.back()->llvmFunction);
-    this->valueStack.push_back(BranchInst::Create(startBlock, endBlock, condition, this->currentBlock));
-
-
-    this->currentBlock = startBlock;
-    mirIf->block->blockInitialized = true;
-    mirIf->block->accept(this);
-
-    if (!mirIf->jumpOver) {
-        //BranchInst::Create(endBlock, this->currentBlock);
-    }
-
-    this->currentBlock = endBlock;
-    if (mirIf->hasNextBlock()) {
-        mirIf->elseBlock->accept(this);
-    }
-}
-
 void ToLLVMVisitor::visit(MIRToPtr *mirToPtr) {
     mirToPtr->expr->accept(this);
     auto value = this->valueStack.back();
@@ -75,6 +75,9 @@ public:
     StructType* int32StructType{};
     StructType* anyTypeStructType{};
 
+    int int32CacheMin = -128; //boxed Int32 values in range come from the immortal table, see getInt32Cache
+    int int32CacheMax = 1023;
+
     std::map<std::string, FunctionCallee> definedLLVMFunctions;
 
     RocLLVMContext(LLVMContext *llvmContext, Module *module);
@@ -110,7 +113,7 @@ public:
 
     void visit(MIRFunction *mirFunction) override;
 
-    void visit(MIRBlock *block) override;
+    void visit(MIRBasicBlock *mirBasicBlock) override;
 
     void visit(MIRCCall *mircCall) override;
 
@@ -176,8 +179,6 @@ public:
 
     void visitFalse(MIRFalse *mirFalse) override;
 
-    void visitIf(MIRIf *mirIf) override;
-
     void visit(MIRToPtr *mirToPtr) override;
 };
 
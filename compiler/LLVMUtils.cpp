@@ -7,6 +7,7 @@
 #include "Types.h"
 #include "LLVMBackend.h"
 #include "Builtins.h"
+#include "../linking/API.h"
 
 using namespace llvm;
 
@@ -82,6 +83,9 @@ Value* getPointerTo(RocLLVMContext *rocLLVMContext, Value* from, BasicBlock *pla
     return gep;
 }
 
+/**
+ * Allocates runtime memory with rocAlloc (see linking/Allocator.h), small sizes come from size-class slabs
+ */
 Value* callMalloc(LLVMContext *llvmContext,
                   Module *module,
                   long long size,
@@ -93,7 +97,7 @@ Value* callMalloc(LLVMContext *llvmContext,
     auto* mallocFunType = FunctionType::get(Type::getInt8PtrTy(*llvmContext), {
             Type::getInt64Ty(*llvmContext),
     }, false);
-    auto mallocFun = module->getOrInsertFunction("malloc", mallocFunType);
+    auto mallocFun = module->getOrInsertFunction("rocAlloc", mallocFunType);
     auto* result = builder.CreateCall(
             mallocFun,
            {  ConstantInt::get(Type::getInt64Ty(*llvmContext), size) },
@@ -193,8 +197,8 @@ void createInt32VTable(RocLLVMContext *rocLlvmContext) {
     std::map<int, std::vector<VTableEntry*>> traitEntries;
 
     std::vector<RocType*> matchingTraits;
-    auto anyType = std::make_unique<RocAnyType>();
-    matchingTraits.push_back(anyType.get());
+    auto anyType = TypeTable::anyType();
+    matchingTraits.push_back(anyType);
     traitEntries.insert({
        anyType->typeId(),
        {
@@ -203,8 +207,7 @@ void createInt32VTable(RocLLVMContext *rocLlvmContext) {
        }
     });
 
-    auto int32Type = std::make_unique<RocInt32Type>();
-    createVTable(rocLlvmContext, int32Type.get(), matchingTraits, traitEntries);
+    createVTable(rocLlvmContext, TypeTable::int32Type(), matchingTraits, traitEntries);
 }
 
 void createStringRawVTable(RocLLVMContext *rocLlvmContext) {
@@ -222,8 +225,8 @@ void createStringRawVTable(RocLLVMContext *rocLlvmContext) {
 
     std::map<int, std::vector<VTableEntry*>> traitEntries;
     std::vector<RocType*> matchingTraits;
-    auto anyType = std::make_unique<RocAnyType>();
-    matchingTraits.push_back(anyType.get());
+    auto anyType = TypeTable::anyType();
+    matchingTraits.push_back(anyType);
     traitEntries.insert({
                                 anyType->typeId(),
                                 {
@@ -232,8 +235,13 @@ void createStringRawVTable(RocLLVMContext *rocLlvmContext) {
                                 }
                         });
 
-    auto t = std::make_unique<RocRawStringType>(-1);
-    createVTable(rocLlvmContext, t.get(), matchingTraits, traitEntries);
+    createVTable(rocLlvmContext, TypeTable::rawStringType(-1), matchingTraits, traitEntries);
+}
+
+Constant* getVTableAddress(RocLLVMContext *rocLlvmContext, RocType *rocType) {
+    auto vTableType = ArrayType::get(rocLlvmContext->int64Type, ROC_VTABLE_SIZE);
+    auto vTable = rocLlvmContext->module->getOrInsertGlobal(rocType->prettyName() + ".vtable", vTableType);
+    return ConstantExpr::getPtrToInt(vTable, rocLlvmContext->int64Type);
 }
 
 void createVTable(RocLLVMContext *rocLlvmContext,
@@ -241,122 +249,25 @@ void createVTable(RocLLVMContext *rocLlvmContext,
                   std::vector<RocType*> matchingTraits,
                   std::map<int, std::vector<VTableEntry*>> traitEntries) {
 
-    auto llvmContext = rocLlvmContext->llvmContext;
     auto module = rocLlvmContext->module;
 
-    IRBuilder<> builder(*llvmContext);
-
-    auto vtableGlobal = module->getOrInsertGlobal(
-            rocType->prettyName() + ".vtable.traits",
-            rocLlvmContext->int64Type //unordered map
-            );
-    GlobalVariable *gv = module->getNamedGlobal(rocType->prettyName() + ".vtable.traits");
-    gv->setLinkage(llvm::GlobalValue::ExternalLinkage);
-    gv->setAlignment(MaybeAlign(8));
-    gv->setInitializer(ConstantInt::get(Type::getInt64Ty(*llvmContext), 0)); //init to zero
-    auto functionType = FunctionType::get(
-            rocLlvmContext->int64Type,
-            { },
-            false);
-    auto vtableGlobalInit = Function::Create(functionType,
-                                             Function::ExternalLinkage,
-                                             rocType->prettyName() + ".vtable.init",
-                                             module);
-    BasicBlock *entry = BasicBlock::Create(*llvmContext, "entrypoint", vtableGlobalInit);
-    builder.SetInsertPoint(entry);
-
-    std::vector<Value*> fPointers;
-    fPointers.push_back(ConstantInt::get(Type::getInt32Ty(*llvmContext), 2)); //number of pointers
-    int k = 0;
+    //slots not implemented by the type stay null
+    std::vector<Constant*> slots(ROC_VTABLE_SIZE, ConstantInt::get(rocLlvmContext->int64Type, 0));
     for (auto& rt : matchingTraits) {
-        auto entries = traitEntries.find(rt->typeId())->second;
-        int i = 0;
-        for (auto& e : entries) {
-            FunctionCallee f = e->getFunctionCallee();
-            auto typeId = rt->typeId();
-            auto fPtr = CastInst::CreatePointerCast(f.getCallee(), rocLlvmContext->int64Type, "", entry);
-            auto fIdentifier = e->getFunctionId();
-
-            auto structRef = callMalloc(rocLlvmContext->llvmContext,
-                                        module,
-                                        8 + 8 + 8,
-                                        entry,
-                                        "struct-malloc");
-            auto* cast = BitCastInst::Create(Instruction::BitCast,
-                                              structRef,
-                                              rocLlvmContext->functionEntryType->getPointerTo(),
-                                              "",
-                                              entry);
-            //Set type id
-            std::vector<Value*> gep1Args;
-            gep1Args.push_back(ConstantInt::get(Type::getInt32Ty(*llvmContext), 0));
-            gep1Args.push_back(ConstantInt::get(Type::getInt32Ty(*llvmContext), 0));
-            auto* gep1 = GetElementPtrInst::Create(rocLlvmContext->functionEntryType,
-                                                   cast,
-                                                   gep1Args,
-                                                   "",
-                                                   entry);
-            new StoreInst(ConstantInt::get(Type::getInt64Ty(*llvmContext), typeId),
-                          gep1,
-                          false,
-                          entry);
-
-            //fPtr
-            std::vector<Value*> gep2Args;
-            gep2Args.push_back(ConstantInt::get(Type::getInt32Ty(*llvmContext), 0));
-            gep2Args.push_back(ConstantInt::get(Type::getInt32Ty(*llvmContext), 1));
-            auto* gep2 = GetElementPtrInst::Create(rocLlvmContext->functionEntryType,
-                                                   cast,
-                                                   gep2Args,
-                                                   "",
-                                                   entry);
-            new StoreInst(fPtr,
-                          gep2,
-                          false,
-                          entry);
-
-            //fIdentifier
-            std::vector<Value*> gep3Args;
-            gep3Args.push_back(ConstantInt::get(Type::getInt32Ty(*llvmContext), 0));
-            gep3Args.push_back(ConstantInt::get(Type::getInt32Ty(*llvmContext), 2));
-            auto* gep3 = GetElementPtrInst::Create(rocLlvmContext->functionEntryType,
-                                                   cast,
-                                                   gep3Args,
-                                                   "",
-                                                   entry);
-            new StoreInst(ConstantInt::get(Type::getInt64Ty(*llvmContext), fIdentifier),
-                          gep3,
-                          false,
-                          entry);
-
-            fPointers.push_back(cast);
-            i++;
+        for (auto& e : traitEntries.find(rt->typeId())->second) {
+            auto f = cast<Constant>(e->getFunctionCallee().getCallee());
+            slots[e->getFunctionId()] = ConstantExpr::getPtrToInt(f, rocLlvmContext->int64Type);
         }
-        k++;
     }
 
-    auto* ft = FunctionType::get(Type::getInt64Ty(*llvmContext), {
-            rocLlvmContext->int32Type,
-    }, true);
-    auto f = module->getOrInsertFunction("myVTableFactory", ft);
-    auto vtableMap = builder.CreateCall(f, fPointers, "call-myVTableFactory");
-    new StoreInst(vtableMap, vtableGlobal, false, entry);
-
-    auto vtableSetterFT = FunctionType::get(rocLlvmContext->voidType, {
-            rocLlvmContext->int64Type,
-            rocLlvmContext->int64Type,
-    }, false);
-    auto vtableSetter = module->getOrInsertFunction("addVTableMapping", vtableSetterFT);
-
-    //Return statement
-    auto* loadInst = new LoadInst(rocLlvmContext->int64Type,
-                                  vtableGlobal,
-                                  "get-global",
-                                  entry);
-    builder.CreateCall(vtableSetter, {
-        ConstantInt::get(Type::getInt64Ty(*llvmContext), rocType->typeId()),
-        loadInst }, "");
-    ReturnInst::Create(*llvmContext, loadInst, entry);
+    //table is constant data of the module, objects only store its address (see getVTableAddress)
+    getVTableAddress(rocLlvmContext, rocType);
+    auto vTableType = ArrayType::get(rocLlvmContext->int64Type, ROC_VTABLE_SIZE);
+    GlobalVariable *gv = module->getNamedGlobal(rocType->prettyName() + ".vtable");
+    gv->setLinkage(llvm::GlobalValue::InternalLinkage);
+    gv->setConstant(true);
+    gv->setAlignment(MaybeAlign(8));
+    gv->setInitializer(ConstantArray::get(vTableType, slots));
 }
 
 Value* newRocRawStruct(ToLLVMVisitor *visitor, Value* rawString, int length) {
@@ -368,17 +279,105 @@ Value* newRocRawStruct(ToLLVMVisitor *visitor, Value* rawString, int length) {
             visitor->rocLLVMContext->stringRawType->getPointerTo(),
             Type::getInt8PtrTy(*visitor->llvmContext),
             Type::getInt32Ty(*visitor->llvmContext),
+            visitor->rocLLVMContext->int64Type,
     }, false);
     auto f = visitor->module->getOrInsertFunction("myInitRawString", ft);
     CallInst::Create(f, {
         rawStrAlloc,
                           rawString,
-                          ConstantInt::get(Type::getInt32Ty(*visitor->llvmContext), length)
+                          ConstantInt::get(Type::getInt32Ty(*visitor->llvmContext), length),
+                          getVTableAddress(visitor->rocLLVMContext, TypeTable::rawStringType(length))
                           }, "", visitor->currentBlock);
     return rawStrAlloc;
 }
 
+GlobalVariable* getInt32Cache(RocLLVMContext *rocLlvmContext) {
+    auto module = rocLlvmContext->module;
+    auto cache = module->getNamedGlobal("Int32.cache");
+    if (cache) {
+        return cache;
+    }
+    auto int32StructType = rocLlvmContext->int32StructType;
+    auto vTable = getVTableAddress(rocLlvmContext, TypeTable::int32Type());
+    std::vector<Constant*> entries;
+    for (long long v = rocLlvmContext->int32CacheMin; v <= rocLlvmContext->int32CacheMax; v++) {
+        entries.push_back(ConstantStruct::get(int32StructType, {
+                vTable,
+                ConstantInt::get(rocLlvmContext->int64Type, TypeTable::int32Type()->typeId()),
+                ConstantInt::get(rocLlvmContext->int64Type, ROC_IMMORTAL_REFC),
+                ConstantInt::get(rocLlvmContext->int32Type, v, true),
+        }));
+    }
+    auto cacheType = ArrayType::get(int32StructType, entries.size());
+    //immortal objects are never written, so the table is constant data
+    return new GlobalVariable(*module,
+                              cacheType,
+                              true,
+                              GlobalValue::InternalLinkage,
+                              ConstantArray::get(cacheType, entries),
+                              "Int32.cache");
+}
+
+static Constant* getCachedInt32(RocLLVMContext *rocLlvmContext, long long value) {
+    auto cache = getInt32Cache(rocLlvmContext);
+    return ConstantExpr::getInBoundsGetElementPtr(cache->getValueType(), cache, ArrayRef<Constant*>{
+            ConstantInt::get(rocLlvmContext->int64Type, 0),
+            ConstantInt::get(rocLlvmContext->int64Type, value - rocLlvmContext->int32CacheMin),
+    });
+}
+
 Value* newRocInt32Struct(ToLLVMVisitor *visitor, Value* value) {
+    auto rocLlvmContext = visitor->rocLLVMContext;
+    long long cacheMin = rocLlvmContext->int32CacheMin;
+    long long cacheMax = rocLlvmContext->int32CacheMax;
+    if (cacheMin > cacheMax || cacheMax - cacheMin >= Config::int32CacheLimit) {
+        return newRocInt32Box(visitor, value);
+    }
+
+    if (auto constant = dyn_cast<ConstantInt>(value)) {
+        auto v = constant->getSExtValue();
+        if (v >= cacheMin && v <= cacheMax) {
+            return getCachedInt32(rocLlvmContext, v);
+        }
+        return newRocInt32Box(visitor, value);
+    }
+
+    //(unsigned) (value - min) <= max - min selects the cached box, otherwise a new one is initialized
+    auto llvmContext = visitor->llvmContext;
+    auto function = visitor->currentBlock->getParent();
+    auto next = visitor->currentBlock->getNextNode();
+    auto cachedBlock = BasicBlock::Create(*llvmContext, "int32-cached", function, next);
+    auto boxedBlock = BasicBlock::Create(*llvmContext, "int32-boxed", function, next);
+    auto endBlock = BasicBlock::Create(*llvmContext, "int32-box-end", function, next);
+
+    IRBuilder<> builder(visitor->currentBlock);
+    auto index = builder.CreateSub(value, ConstantInt::get(rocLlvmContext->int32Type, cacheMin), "int32-cache-index");
+    auto inRange = builder.CreateICmpULE(index,
+                                         ConstantInt::get(rocLlvmContext->int32Type, cacheMax - cacheMin),
+                                         "int32-cached");
+    builder.CreateCondBr(inRange, cachedBlock, boxedBlock);
+
+    builder.SetInsertPoint(cachedBlock);
+    auto cache = getInt32Cache(rocLlvmContext);
+    auto cached = builder.CreateInBoundsGEP(cache->getValueType(), cache, {
+            ConstantInt::get(rocLlvmContext->int64Type, 0),
+            builder.CreateZExt(index, rocLlvmContext->int64Type),
+    }, "int32-cached-box");
+    builder.CreateBr(endBlock);
+
+    visitor->currentBlock = boxedBlock;
+    auto boxed = newRocInt32Box(visitor, value);
+    BranchInst::Create(endBlock, boxedBlock);
+
+    builder.SetInsertPoint(endBlock);
+    auto result = builder.CreatePHI(rocLlvmContext->int32StructType->getPointerTo(), 2, "int32-box");
+    result->addIncoming(cached, cachedBlock);
+    result->addIncoming(boxed, boxedBlock);
+    visitor->currentBlock = endBlock;
+    return result;
+}
+
+Value* newRocInt32Box(ToLLVMVisitor *visitor, Value* value) {
     auto alloc = new AllocaInst(visitor->rocLLVMContext->int32StructType,
                                       0,
                                       "new-int-32",
@@ -386,8 +385,21 @@ Value* newRocInt32Struct(ToLLVMVisitor *visitor, Value* value) {
     auto ft = FunctionType::get(Type::getVoidTy(*visitor->llvmContext), {
             visitor->rocLLVMContext->int32StructType->getPointerTo(),
             Type::getInt32Ty(*visitor->llvmContext),
+            visitor->rocLLVMContext->int64Type,
     }, false);
     auto f = visitor->module->getOrInsertFunction("myInitInt32", ft);
-    CallInst::Create(f, { alloc, value }, "", visitor->currentBlock);
+    CallInst::Create(f, {
+            alloc,
+            value,
+            getVTableAddress(visitor->rocLLVMContext, TypeTable::int32Type())
+    }, "", visitor->currentBlock);
     return alloc;
-}
\ No newline at end of file
+}
+
+void releaseObject(ToLLVMVisitor *visitor, Value* object) {
+    auto anyPtrType = visitor->rocLLVMContext->anyTypeStructType->getPointerTo();
+    auto ft = FunctionType::get(Type::getVoidTy(*visitor->llvmContext), {anyPtrType}, false);
+    auto f = visitor->module->getOrInsertFunction("myDecr", ft);
+    auto any = BitCastInst::Create(Instruction::BitCast, object, anyPtrType, "release-as-any", visitor->currentBlock);
+    CallInst::Create(f, {any}, "", visitor->currentBlock);
+}
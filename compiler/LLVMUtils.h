@@ -10,6 +10,8 @@ namespace llvm {
     class Module;
     class BasicBlock;
     class Value;
+    class Constant;
+    class GlobalVariable;
 }
 
 class RocType;
@@ -17,8 +19,29 @@ class RocLLVMContext;
 class ToLLVMVisitor;
 
 llvm::Value* newRocRawStruct(ToLLVMVisitor *visitor, llvm::Value* rawString, int length);
+
+/**
+ * Boxes Int32 value, values in the range of RocLLVMContext::int32CacheMin..int32CacheMax come from the immortal
+ * table of getInt32Cache, others are initialized by newRocInt32Box. Ranges wider than Config::int32CacheLimit
+ * are not cached
+ */
 llvm::Value* newRocInt32Struct(ToLLVMVisitor *visitor, llvm::Value* value);
 
+/**
+ * Initializes new box of Int32 value on the stack
+ */
+llvm::Value* newRocInt32Box(ToLLVMVisitor *visitor, llvm::Value* value);
+
+/**
+ * Drops a reference to given runtime object with myDecr, the object is freed when nothing references it
+ */
+void releaseObject(ToLLVMVisitor *visitor, llvm::Value* object);
+
+/**
+ * @return constant table of boxed Int32 values (Int32.cache) marked as immortal, created on first use
+ */
+llvm::GlobalVariable* getInt32Cache(RocLLVMContext *rocLlvmContext);
+
 void createPuts(llvm::LLVMContext *llvmContext,
                 llvm::Module *module,
                 const std::string& text,
@@ -29,12 +52,25 @@ void createFunctionDispatcherForAny(RocLLVMContext *rocLLVMContext);
 void createStringRawVTable(RocLLVMContext *rocLlvmContext);
 void createInt32VTable(RocLLVMContext *rocLlvmContext);
 
+/**
+ * @return address (as i64 constant) of the virtual table of given type, a constant global initialized by
+ * createInt32VTable or createStringRawVTable, so no code runs at startup to build it
+ */
+llvm::Constant* getVTableAddress(RocLLVMContext *rocLlvmContext, RocType *rocType);
+
 llvm::Value* callMalloc(llvm::LLVMContext *llvmContext,
                         llvm::Module *module,
                         long long size,
                         llvm::BasicBlock *place,
                         const std::string& name = "");
 
+llvm::Value* getFieldFromStruct(llvm::LLVMContext *llvmContext,
+                                llvm::Type *structType,
+                                llvm::Value *ptrValue,
+                                int fieldIndex,
+                                llvm::Type *fieldType,
+                                llvm::BasicBlock *place);
+
 llvm::Value* castTo(llvm::Value* from, llvm::Type *to, llvm::BasicBlock *place);
 
 llvm::Value* getPointerTo(RocLLVMContext *rocLLVMContext, llvm::Value* from, llvm::BasicBlock *place, int index);
@@ -9,12 +9,18 @@
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/MC/MCAsmInfo.h"
+#include "llvm/MC/SubtargetFeature.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Passes/PassBuilder.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/Host.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Target/TargetMachine.h"
 #include <fstream>
+#include <functional>
 #include <utility>
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include "RocCompiler.h"
@@ -23,12 +29,27 @@
 #include "Builtins.h"
 #include "Extensions.h"
 #include "../linking/API.h"
+#include "../linking/Allocator.h"
+#include "../linking/Format.h"
+#include "../linking/Output.h"
 #include "../linking/Math.h"
 #include "../passes/MemoryPass.h"
+#include "../passes/DevirtualizationPass.h"
+#include "../passes/ControlFlowPass.h"
+#include "../passes/PassManager.h"
+#include "TimeReport.h"
 
 using namespace llvm;
 
+#if LLVM_VERSION_MAJOR >= 14
+using RocOptimizationLevel = llvm::OptimizationLevel;
+#else
+using RocOptimizationLevel = llvm::PassBuilder::OptimizationLevel;
+#endif
+
 CompilationContext::CompilationContext() {
+    this->typeTable = std::make_shared<TypeTable>();
+    TypeTable::Scope typeTableScope(this->typeTable.get());
     this->config = std::make_unique<Config>();
     this->builtinFunctionResolver = new BuiltinFunctionResolver();
 };
@@ -48,39 +69,21 @@ void CompilationContext::pushCompilationNode(CompilationNode *cn) {
     }
 }
 
-TargetFunctionCall * CompilationContext::findFunctionByName(int typeId, const std::string& name, int args) {
-    auto vec = this->targetFunctionsRegister.find(typeId);
-    if (vec == this->targetFunctionsRegister.end()) {
-        return nullptr;
-    }
-    for (auto& f: vec->second) {
-        if (f->getName() == name && f->getArgumentTypes().size() == args) {
-            return f;
-        }
-    }
-    return nullptr;
+void CompilationContext::setInterner(std::shared_ptr<Interner> interner) {
+    this->interner = std::move(interner);
+    this->symbolIndex.interner = this->interner.get();
+}
+
+TargetFunctionCall * CompilationContext::findFunctionByName(int typeId, SymbolId name, int args) {
+    return this->symbolIndex.find(typeId, name, args);
 }
 
 void CompilationContext::insertTargetFunction(FunctionDeclarationTargetWrapper *target) {
-    auto it = this->targetFunctionsRegister.find(-1);
-    if (it != this->targetFunctionsRegister.end()) {
-        it->second.push_back(target);
-    } else {
-        std::vector<TargetFunctionCall*> vec;
-        vec.push_back(target);
-        this->targetFunctionsRegister.insert({-1, vec});
-    }
+    this->symbolIndex.insert(moduleFunctionsTypeId, target);
 }
 
 void CompilationContext::insertTargetFunction(PredefinedTargetMethodCall *target) {
-    auto it = this->targetFunctionsRegister.find(target->owner->typeId());
-    if (it != this->targetFunctionsRegister.end()) {
-        it->second.push_back(target);
-    } else {
-        std::vector<TargetFunctionCall*> vec;
-        vec.push_back(target);
-        this->targetFunctionsRegister.insert({target->owner->typeId(), vec});
-    }
+    this->symbolIndex.insert(target->owner->typeId(), target);
 }
 
 void CompilationContext::reportProblem(const char *msg, ASTNode *toMark) {
@@ -101,32 +104,63 @@ CompilationNode *CompilationContext::popCompilationNode() {
     }
 }
 
-RocCompilationResult * RocCompiler::compile(const std::string& filePath) {
-    Lexer lexer(filePath);
-    ParseContext parseContext(&lexer);
+static RocCompilationResult* compileLexed(const std::function<std::unique_ptr<Lexer>()>& newLexer,
+                                          const std::string& filePath,
+                                          const Config& config) {
+    TraceSession traceSession(config.traceFile, "roc-lang");
+    auto ctx = std::make_unique<CompilationContext>();
+    *ctx->config = config;
+    ctx->timeReport->enabled = config.timeReport || !config.timeReportJSON.empty();
+
+    std::unique_ptr<Lexer> lexer;
+    {
+        TimeReport::Phase phase(ctx->timeReport.get(), "load source");
+        lexer = newLexer();
+    }
+    ParseContext parseContext(lexer.get());
 
     try {
         ModuleParser moduleParser(&parseContext);
         moduleParser.absolutePath = filePath;
-        moduleParser.parse();
+        {
+            //tokens are lexed on demand by the parser, so lexing is measured together with parsing
+            TimeReport::Phase phase(ctx->timeReport.get(), "lex and parse");
+            moduleParser.parse();
+        }
         if (!moduleParser.syntaxExceptions.empty()) {
-            for (const auto &item : moduleParser.syntaxExceptions) item.printMessage();
+            for (const auto &item : moduleParser.syntaxExceptions) item.printMessage(lexer->content);
             return nullptr;
         }
         auto md = moduleParser.parseContext->moduleDeclarations.back();
-        auto ctx = std::make_unique<CompilationContext>();
+        ctx->sourceBuffer = lexer->buffer;
+        ctx->source = lexer->content;
         return RocCompiler::compile(std::move(md), ctx.get());
     } catch (SyntaxException &ex) {
-        ex.printMessage();
+        ex.printMessage(lexer->content);
         return nullptr;
     }
 }
 
-RocCompilationResult* RocCompiler::compile(const std::string& expr, const std::string& outputFileName) {
-    std::ofstream f(outputFileName);
-    f << expr;
-    f.close();
-    return compile(outputFileName);
+RocCompilationResult * RocCompiler::compile(const std::string& filePath, const Config& config) {
+    return compileLexed([&] { return std::make_unique<Lexer>(filePath); }, filePath, config);
+}
+
+RocCompilationResult* RocCompiler::compile(const std::string& expr,
+                                           const std::string& filePath,
+                                           const Config& config) {
+    return compileSource(expr, filePath, config);
+}
+
+RocCompilationResult* RocCompiler::compileSource(std::string_view source,
+                                                 const std::string& filePath,
+                                                 const Config& config) {
+    return compileLexed([&] { return std::make_unique<Lexer>(std::string(source), filePath); }, filePath, config);
+}
+
+RocCompilationResult* RocCompiler::compileSource(std::shared_ptr<SourceBuffer> source,
+                                                 const std::string& filePath,
+                                                 const Config& config) {
+    return compileLexed([&] { return std::make_unique<Lexer>(std::move(source), filePath); }, filePath, config);
 }
 
 RocCompilationResult* RocCompiler::compile(std::shared_ptr<ModuleDeclaration> moduleDeclaration,
@@ -135,31 +169,65 @@ RocCompilationResult* RocCompiler::compile(std::shared_ptr<ModuleDeclaration> mo
     //ASTPrinter astPrinter;
     //moduleDeclaration->accept(&astPrinter);
 
-    LiteralResolver literalResolver(compilationContext);
-    literalResolver.visit(moduleDeclaration.get());
+    TypeTable::Scope typeTableScope(compilationContext->typeTable.get());
+
+    if (moduleDeclaration->interner) {
+        compilationContext->setInterner(moduleDeclaration->interner);
+    }
+
+    auto config = compilationContext->config.get();
+    auto timeReport = compilationContext->timeReport.get();
+    timeReport->enabled = config->timeReport || !config->timeReportJSON.empty();
 
-    FunctionSignatureResolver functionSignatureResolver(compilationContext);
-    functionSignatureResolver.visit(moduleDeclaration.get());
+    {
+        TimeReport::Phase phase(timeReport, "literal resolver");
+        LiteralResolver literalResolver(compilationContext);
+        literalResolver.visit(moduleDeclaration.get());
+    }
+
+    {
+        TimeReport::Phase phase(timeReport, "signature resolver");
+        FunctionSignatureResolver functionSignatureResolver(compilationContext);
+        functionSignatureResolver.visit(moduleDeclaration.get());
+    }
 
-    TypeResolver typeResolver(compilationContext);
-    typeResolver.visit(moduleDeclaration.get());
+    {
+        TimeReport::Phase phase(timeReport, "type resolver");
+        TypeResolver typeResolver(compilationContext);
+        typeResolver.visit(moduleDeclaration.get());
+    }
 
     if (!compilationContext->typeProblems.empty()) {
         for (auto problem: compilationContext->typeProblems) {
-            problem->printMessage();
+            if (compilationContext->source.empty()) {
+                problem->printMessage();
+            } else {
+                problem->printMessage(compilationContext->source);
+            }
         }
         return nullptr;
     }
 
     LLVMBackendProvider backendProvider;
-    return backendProvider.compile(std::move(moduleDeclaration), compilationContext);
+    auto result = backendProvider.compile(std::move(moduleDeclaration), compilationContext);
+
+    if (result) {
+        result->compilePhases = timeReport->phases;
+    }
+    if (config->timeReport) {
+        timeReport->print(errs());
+    }
+    if (!config->timeReportJSON.empty() && !timeReport->writeJSON(config->timeReportJSON)) {
+        errs() << "Could not write time report: " << config->timeReportJSON << "\n";
+    }
+    return result;
 }
 
 void LiteralResolver::visit(LiteralExpr *literalExpr) {
     if (this->compilationContext->currentCompilationNode()->isFunctionDeclaration()) {
         auto fd = (FunctionDeclaration*) this->compilationContext->currentCompilationNode();
-        auto localSymbols = fd->localSymbols;
-        auto it = localSymbols.find(literalExpr->literal->getText());
+        auto& localSymbols = fd->localSymbols;
+        auto it = localSymbols.find(literalExpr->literal->symbol);
         if (it != localSymbols.end()) {
             auto localAccess = std::make_unique<LocalAccess>(std::move(literalExpr->literal));
             localAccess->localVariableRef = it->second;
@@ -181,7 +249,7 @@ void LiteralResolver::visit(FunctionDeclaration *functionDeclaration) {
         lv->name = p->name->getText();
         lv->index = i;
         lv->parameter = p;
-        functionDeclaration->localSymbols.insert({p->getText(), lv.get()});
+        functionDeclaration->localSymbols.insert({((Literal*) p->name)->symbol, lv.get()});
         functionDeclaration->locals.push_back(std::move(lv));
         i++;
     }
@@ -203,6 +271,76 @@ BackendProvider::BackendProvider(RocBackendType backendType) : backendType(backe
 
 LLVMBackendProvider::LLVMBackendProvider() : BackendProvider(RocBackendType::llvmB) {}
 
+/**
+ * Runs the default new pass manager pipeline for given optimization level (-O1 ... -O3) over the module
+ */
+void optimizeModule(Module* M, TargetMachine* targetMachine, int optimizationLevel) {
+    if (optimizationLevel <= 0) {
+        return;
+    }
+
+    LoopAnalysisManager loopAnalysisManager;
+    FunctionAnalysisManager functionAnalysisManager;
+    CGSCCAnalysisManager cgsccAnalysisManager;
+    ModuleAnalysisManager moduleAnalysisManager;
+
+    PassBuilder passBuilder(targetMachine);
+    passBuilder.registerModuleAnalyses(moduleAnalysisManager);
+    passBuilder.registerCGSCCAnalyses(cgsccAnalysisManager);
+    passBuilder.registerFunctionAnalyses(functionAnalysisManager);
+    passBuilder.registerLoopAnalyses(loopAnalysisManager);
+    passBuilder.crossRegisterProxies(loopAnalysisManager,
+                                     functionAnalysisManager,
+                                     cgsccAnalysisManager,
+                                     moduleAnalysisManager);
+
+    RocOptimizationLevel level = RocOptimizationLevel::O1;
+    if (optimizationLevel == 2) {
+        level = RocOptimizationLevel::O2;
+    } else if (optimizationLevel >= 3) {
+        level = RocOptimizationLevel::O3;
+    }
+    auto modulePassManager = passBuilder.buildPerModuleDefaultPipeline(level);
+    modulePassManager.run(*M, moduleAnalysisManager);
+}
+
+/**
+ * Resolves --mcpu and --mattr values, "native" is replaced by the host CPU name and host CPU features
+ */
+void resolveTarget(Config *config, std::string& cpu, std::string& features) {
+    cpu = config->targetCpu.empty() ? "generic" : config->targetCpu;
+    bool nativeFeatures = config->targetFeatures == "native" || (cpu == "native" && config->targetFeatures.empty());
+    if (cpu == "native") {
+        cpu = sys::getHostCPUName().str();
+    }
+
+    SubtargetFeatures subtargetFeatures(nativeFeatures ? "" : config->targetFeatures);
+    if (nativeFeatures) {
+        StringMap<bool> hostFeatures;
+        if (sys::getHostCPUFeatures(hostFeatures)) {
+            for (auto& f: hostFeatures) {
+                subtargetFeatures.AddFeature(f.first(), f.second);
+            }
+        }
+    }
+    features = subtargetFeatures.getString();
+}
+
+/**
+ * Stores selected target on every function and as a comment in the emitted assembly
+ */
+void recordTarget(Module* M, TargetMachine* targetMachine, const std::string& cpu, const std::string& features) {
+    for (auto& f: *M) {
+        if (f.isDeclaration()) continue;
+        f.addFnAttr("target-cpu", cpu);
+        if (!features.empty()) f.addFnAttr("target-features", features);
+    }
+    auto commentString = targetMachine->getMCAsmInfo()->getCommentString().str();
+    auto comment = commentString + " roc target-cpu: " + cpu;
+    if (!features.empty()) comment += ", target-features: " + features;
+    M->appendModuleInlineAsm(comment);
+}
+
 int verifyModule1(Module* M) {
     errs() << "verifying... ";
     if (verifyModule(*M)) {
@@ -213,6 +351,79 @@ int verifyModule1(Module* M) {
     return 0;
 }
 
+/**
+ * Writes assembly, object file or textual IR of the module, the module is not executed
+ *
+ * @return false if the file could not be written, the reason is printed
+ */
+static bool emitModule(Module *M, TargetMachine *targetMachine, RocOutputMode outputMode, const std::string& path) {
+    std::error_code EC;
+    raw_fd_ostream dest(path, EC, outputMode == emitObj ? sys::fs::OF_None : sys::fs::OF_Text);
+
+    if (EC) {
+        errs() << "Could not open file: " << path << ": " << EC.message() << "\n";
+        return false;
+    }
+
+    if (outputMode == emitIR) {
+        M->print(dest, nullptr);
+    } else {
+        legacy::PassManager pass;
+        auto FileType = outputMode == emitObj ? CGFT_ObjectFile : CGFT_AssemblyFile;
+
+        if (targetMachine->addPassesToEmitFile(pass, dest, nullptr, FileType)) {
+            errs() << "TheTargetMachine can't emit a file of this type\n";
+            return false;
+        }
+
+        pass.run(*M);
+    }
+    dest.flush();
+
+    if (dest.has_error()) {
+        errs() << "Could not write file: " << path << ": " << dest.error().message() << "\n";
+        dest.clear_error();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Creates MCJIT engine over the module with runtime functions of linking/ mapped in
+ */
+static ExecutionEngine* createExecutionEngine(std::unique_ptr<Module> module,
+                                              const std::string& CPU,
+                                              const std::string& features) {
+    std::string errStr;
+    auto *EE =
+            EngineBuilder(std::move(module))
+                    .setErrorStr(&errStr)
+                    .setMCPU(CPU)
+                    .setMAttrs(SubtargetFeatures(features).getFeatures())
+                    .create();
+    if (!EE) {
+        errs() << "Could not create execution engine: " << errStr << "\n";
+        return nullptr;
+    }
+    EE->addGlobalMapping("rocFormatInt32", (uint64_t) rocFormatInt32);
+    EE->addGlobalMapping("myGetFunctionPointer", (uint64_t) myGetFunctionPointer);
+    EE->addGlobalMapping("myPrintln", (uint64_t) myPrintln);
+    EE->addGlobalMapping("myPrint", (uint64_t) myPrint);
+    EE->addGlobalMapping("myInt32ToString", (uint64_t) myInt32ToString);
+    EE->addGlobalMapping("myStringRawRTypeToString", (uint64_t) myStringRawRTypeToString);
+
+    EE->addGlobalMapping("myInitRawString", (uint64_t) myInitRawString);
+    EE->addGlobalMapping("myInitInt32", (uint64_t) myInitInt32);
+    EE->addGlobalMapping("myDecr", (uint64_t) myDecr);
+
+    EE->addGlobalMapping("rocAlloc", (uint64_t) rocAlloc);
+    EE->addGlobalMapping("rocFree", (uint64_t) rocFree);
+    EE->addGlobalMapping("rocFlush", (uint64_t) rocFlush);
+
+    EE->addGlobalMapping("Sqrt", (uint64_t) Sqrt);
+    return EE;
+}
+
 RocCompilationResult* LLVMBackendProvider::compile(std::shared_ptr<ModuleDeclaration> moduleDeclaration,
                                                    CompilationContext *compilationContext) {
 
@@ -225,25 +436,57 @@ RocCompilationResult* LLVMBackendProvider::compile(std::shared_ptr<ModuleDeclara
     std::unique_ptr<Module> Owner(new Module(moduleDeclaration->moduleName, Context));
     Module *M = Owner.get();
 
+    //all MIR built and rewritten below lives in the module's arena
+    auto mirArena = std::make_unique<Arena>();
+    Arena::Scope mirArenaScope(mirArena.get());
+
+    auto timeReport = compilationContext->timeReport.get();
+
     ToMIRVisitor toMirVisitor;
-    toMirVisitor.visit(moduleDeclaration.get());
+    {
+        TimeReport::Phase phase(timeReport, "to MIR");
+        toMirVisitor.visit(moduleDeclaration.get());
+    }
+    toMirVisitor.mirModule->arena = std::move(mirArena);
     toMirVisitor.mirModule->moduleDeclaration = std::move(moduleDeclaration);
-    toMirVisitor.mirModule->visit(compilationContext->builtinFunctionResolver);
-
-    LabelResolver labelResolver;
-    toMirVisitor.mirModule->visit(&labelResolver);
 
-    SmartTypeCaster smartTypeCaster;
-    toMirVisitor.mirModule->visit(&smartTypeCaster);
+    auto cr = new RocCompilationResult();
+    auto config = compilationContext->config.get();
+
+    //lowering passes always run, optimization passes are picked by --mir-passes and run on the control flow graph
+    MIRPassManager passManager;
+    passManager.verify = config->verifyMIR;
+    passManager.timeReport = timeReport;
+    passManager.addPass("builtins", std::make_unique<MIRSharedVisitorPass>(compilationContext->builtinFunctionResolver));
+    passManager.addPass("labels", std::make_unique<MIRVisitorPass<LabelResolver>>());
+    passManager.addPass("cast", std::make_unique<MIRVisitorPass<SmartTypeCaster>>());
+    passManager.addPass("heap", std::make_unique<MIRVisitorPass<HeapAllocatorLifter>>());
+    passManager.addPass("cfg", std::make_unique<MIRVisitorPass<ControlFlowGraphBuilder>>());
+    passManager.addPasses(config->mirPasses);
+    {
+        TimeReport::Phase phase(timeReport, "MIR passes");
+        passManager.run(toMirVisitor.mirModule.get(), cr);
+    }
 
-    HeapAllocatorLifter heapAllocatorLifter;
-    toMirVisitor.mirModule->visit(&heapAllocatorLifter);
+    if (config->timeMIRPasses) {
+        errs() << "devirtualized call sites: " << cr->devirtualizedCalls << "\n";
+        errs() << "folded constants: " << cr->foldedConstants
+               << ", eliminated blocks: " << cr->eliminatedBlocks << "\n";
+        for (auto& passStatistics: cr->mirPassStatistics) {
+            errs() << format("%-12s %10.3f ms %8zu allocations %10zu bytes\n", passStatistics.name.c_str(),
+                             passStatistics.milliseconds, passStatistics.allocations, passStatistics.allocatedBytes);
+        }
+    }
 
     ToLLVMVisitor visitor(&Context, M);
-    toMirVisitor.mirModule->visit(&visitor);
-    verifyModule1(M);
+    visitor.rocLLVMContext->int32CacheMin = config->int32CacheMin;
+    visitor.rocLLVMContext->int32CacheMax = config->int32CacheMax;
+    {
+        TimeReport::Phase phase(timeReport, "to LLVM");
+        toMirVisitor.mirModule->visit(&visitor);
+        verifyModule1(M);
+    }
 
-    auto cr = new RocCompilationResult();
     auto TargetTriple = sys::getDefaultTargetTriple();
     M->setTargetTriple(TargetTriple);
 
@@ -255,8 +498,11 @@ RocCompilationResult* LLVMBackendProvider::compile(std::shared_ptr<ModuleDeclara
         return cr;
     }
 
-    auto CPU = "generic";
-    auto Features = "";
+    std::string CPU;
+    std::string Features;
+    resolveTarget(compilationContext->config.get(), CPU, Features);
+    cr->targetCpu = CPU;
+    cr->targetFeatures = Features;
 
     TargetOptions opt;
     auto RM = Optional<Reloc::Model>();
@@ -264,51 +510,31 @@ RocCompilationResult* LLVMBackendProvider::compile(std::shared_ptr<ModuleDeclara
             Target->createTargetMachine(TargetTriple, CPU, Features, opt, RM);
 
     M->setDataLayout(TheTargetMachine->createDataLayout());
+    recordTarget(M, TheTargetMachine, CPU, Features);
 
-    auto Filename = "output.s";
-    std::error_code EC;
-    raw_fd_ostream dest(Filename, EC, sys::fs::OF_None);
+    {
+        TimeReport::Phase phase(timeReport, "LLVM optimize");
+        optimizeModule(M, TheTargetMachine, compilationContext->config->optimizationLevel);
+    }
 
-    if (EC) {
-        errs() << "Could not open file: " << EC.message();
+    auto outputMode = compilationContext->config->outputMode;
+    if (outputMode != jitRun) {
+        TimeReport::Phase phase(timeReport, "LLVM codegen");
+        if (!emitModule(M, TheTargetMachine, outputMode, compilationContext->config->getOutputPath())) {
+            delete cr;
+            return nullptr; //the file is the only output of this mode
+        }
         return cr;
     }
 
-    legacy::PassManager pass;
-    auto FileType = CGFT_AssemblyFile;
-
-    if (TheTargetMachine->addPassesToEmitFile(pass, dest, nullptr, FileType)) {
-        errs() << "TheTargetMachine can't emit a file of this type";
+    TimeReport::Phase jitPhase(timeReport, "JIT engine");
+    auto EE = createExecutionEngine(std::move(Owner), CPU, Features);
+    if (!EE) {
         return cr;
     }
-
-    pass.run(*M);
-    dest.flush();
-
-    std::string errStr;
-    auto *EE =
-            EngineBuilder(std::move(Owner))
-                    .setErrorStr(&errStr)
-                    .create();
-    EE->addGlobalMapping("myIntToString", (uint64_t) myIntToString);
-    EE->addGlobalMapping("myVTableFactory", (uint64_t) myVTableFactory);
-    EE->addGlobalMapping("myGetFunctionPointer", (uint64_t) myGetFunctionPointer);
-    EE->addGlobalMapping("myPrintln", (uint64_t) myPrintln);
-    EE->addGlobalMapping("myPrint", (uint64_t) myPrint);
-    EE->addGlobalMapping("myInt32ToString", (uint64_t) myInt32ToString);
-    EE->addGlobalMapping("addVTableMapping", (uint64_t) addVTableMapping);
-    EE->addGlobalMapping("myStringRawRTypeToString", (uint64_t) myStringRawRTypeToString);
-
-    EE->addGlobalMapping("myInitRawString", (uint64_t) myInitRawString);
-    EE->addGlobalMapping("myInitInt32", (uint64_t) myInitInt32);
-
-    EE->addGlobalMapping("Sqrt", (uint64_t) Sqrt);
-
-
-    auto fa = EE->getFunctionAddress("main");
-
+    //MCJIT generates code of the whole module on the first address lookup
     cr->mainFunction = visitor.mainFunction;
-    cr->mainFunctionPtr = fa;
+    cr->mainFunctionPtr = EE->getFunctionAddress("main");
     cr->EE = EE;
 
     return cr;
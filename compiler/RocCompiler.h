@@ -6,7 +6,10 @@
 #define ROC_LANG_ROCCOMPILER_H
 
 #include <vector>
+#include <string_view>
 #include "../parser/AST.h"
+#include "SymbolIndex.h"
+#include "TimeReport.h"
 
 class RocTypeNodeContext;
 class RocCompiler;
@@ -17,6 +20,8 @@ class TargetFunctionCall;
 class FunctionDeclarationTargetWrapper;
 class PredefinedTargetMethodCall;
 class CompileTypeException;
+class SourceBuffer;
+class TypeTable;
 
 namespace llvm {
     class Function;
@@ -80,8 +85,13 @@ public:
     bool mainInitialized = false;
     std::unique_ptr<Config> config;
     BuiltinFunctionResolver *builtinFunctionResolver;
-    std::map<int /* typeId */, std::vector<TargetFunctionCall*>> targetFunctionsRegister{};
+    std::shared_ptr<Interner> interner = std::make_shared<Interner>(); //identifiers, shared with the lexed module
+    SymbolIndex symbolIndex{interner.get()}; //functions and methods registered by FunctionSignatureResolver
     std::vector<CompileTypeException*> typeProblems;
+    std::shared_ptr<SourceBuffer> sourceBuffer; //keeps the source alive for the whole compilation
+    std::string_view source; //source of the compiled module, used for reporting problems
+    std::shared_ptr<TimeReport> timeReport = std::make_shared<TimeReport>(); //phases measured for --time-report
+    std::shared_ptr<TypeTable> typeTable; //composite types of this compilation, active while it runs
 
     CompilationContext();
 
@@ -91,7 +101,12 @@ public:
 
     void pushCompilationNode(CompilationNode *);
 
-    TargetFunctionCall* findFunctionByName(int typeId, const std::string& name, int args);
+    /**
+     * Switches to the interner of the lexed module, must be called before any symbol is registered
+     */
+    void setInterner(std::shared_ptr<Interner> interner);
+
+    TargetFunctionCall* findFunctionByName(int typeId, SymbolId name, int args);
 
     void insertTargetFunction(FunctionDeclarationTargetWrapper *target);
 
@@ -106,19 +121,50 @@ public:
 class RocCompiler {
 public:
 
-    static RocCompilationResult *compile(const std::string& filePath);
+    static RocCompilationResult *compile(const std::string& filePath, const Config& config = Config());
+
+    static RocCompilationResult *compile(const std::string& expr,
+                                         const std::string& filePath,
+                                         const Config& config = Config());
 
-    static RocCompilationResult *compile(const std::string& expr, const std::string& outputFileName);
+    /**
+     * Compiles source held in memory, file path is used only for reporting
+     */
+    static RocCompilationResult *compileSource(std::string_view source,
+                                               const std::string& filePath,
+                                               const Config& config = Config());
+
+    static RocCompilationResult *compileSource(std::shared_ptr<SourceBuffer> source,
+                                               const std::string& filePath,
+                                               const Config& config = Config());
 
     static RocCompilationResult *compile(std::shared_ptr<ModuleDeclaration> moduleDeclaration,
                                          CompilationContext *compilationContext);
 };
 
+/**
+ * Wall time and MIR arena allocations of a single MIR pass, see MIRPassManager
+ */
+class MIRPassStatistics {
+public:
+    std::string name;
+    double milliseconds = 0;
+    size_t allocations = 0;
+    size_t allocatedBytes = 0;
+};
+
 class RocCompilationResult {
 public:
-    uint64_t mainFunctionPtr;
-    llvm::Function *mainFunction;
-    llvm::ExecutionEngine *EE;
+    uint64_t mainFunctionPtr = 0; //set only in jitRun mode
+    llvm::Function *mainFunction = nullptr;
+    llvm::ExecutionEngine *EE = nullptr; //set only in jitRun mode
+    int devirtualizedCalls = 0;
+    int foldedConstants = 0;
+    int eliminatedBlocks = 0;
+    std::vector<MIRPassStatistics> mirPassStatistics; //in order of execution
+    std::vector<CompilePhase> compilePhases; //filled only if time report is enabled in Config
+    std::string targetCpu;
+    std::string targetFeatures;
 };
 
 #endif //ROC_LANG_ROCCOMPILER_H
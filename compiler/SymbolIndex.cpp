@@ -0,0 +1,37 @@
+#include "SymbolIndex.h"
+#include "Types.h"
+
+SymbolIndex::SymbolIndex(Interner *interner) : interner(interner) { }
+
+SymbolIndex::~SymbolIndex() = default;
+
+void SymbolIndex::insert(int typeId, TargetFunctionCall *target) {
+    auto name = interner->intern(target->getName());
+    tables[typeId].insert({key(name, target->getArgumentTypes().size()), target});
+}
+
+TargetFunctionCall* SymbolIndex::find(int typeId, SymbolId name, int arity) {
+    auto table = tables.find(typeId);
+    if (table == tables.end()) {
+        return nullptr;
+    }
+    return find(table->second, name, arity);
+}
+
+TargetFunctionCall* SymbolIndex::findMethod(RocType *type, SymbolId name, int arity) {
+    auto table = methodTables.find(type);
+    if (table == methodTables.end()) {
+        SymbolTable newTable;
+        for (auto& m: type->getMethods()) {
+            methods.push_back(std::unique_ptr<TargetFunctionCall>(m));
+            newTable.insert({key(interner->intern(m->getName()), m->getArgumentTypes().size()), m});
+        }
+        table = methodTables.insert({type, std::move(newTable)}).first;
+    }
+    return find(table->second, name, arity);
+}
+
+TargetFunctionCall* SymbolIndex::find(const SymbolTable &table, SymbolId name, int arity) {
+    auto it = table.find(key(name, arity));
+    return it == table.end() ? nullptr : it->second;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#ifndef ROC_LANG_SYMBOLINDEX_H
+#define ROC_LANG_SYMBOLINDEX_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../parser/Interner.h"
+
+class RocType;
+class TargetFunctionCall;
+
+/**
+ * Owner type id of functions declared in a module
+ */
+static const int moduleFunctionsTypeId = -1;
+
+/**
+ * Index of callable symbols keyed by interned name and arity. Every owner type id has its own table,
+ * methods reachable on a type (see RocType::getMethods) get a table per interned type built on first lookup
+ */
+class SymbolIndex {
+public:
+    Interner* interner; //names of registered targets are interned here
+
+    explicit SymbolIndex(Interner *interner);
+
+    ~SymbolIndex();
+
+    /**
+     * Registers target under the given owner type id, the first target registered for a name and arity wins
+     */
+    void insert(int typeId, TargetFunctionCall *target);
+
+    /**
+     * @return target registered under the owner type id or nullptr
+     */
+    TargetFunctionCall* find(int typeId, SymbolId name, int arity);
+
+    /**
+     * @return method which can be called on a value of the given type or nullptr
+     */
+    TargetFunctionCall* findMethod(RocType *type, SymbolId name, int arity);
+
+private:
+    using SymbolTable = std::unordered_map<uint64_t, TargetFunctionCall*>;
+
+    std::unordered_map<int /* typeId */, SymbolTable> tables;
+    std::unordered_map<RocType*, SymbolTable> methodTables;
+    std::vector<std::unique_ptr<TargetFunctionCall>> methods;
+
+    static TargetFunctionCall* find(const SymbolTable &table, SymbolId name, int arity);
+
+    static uint64_t key(SymbolId name, int arity) {
+        return ((uint64_t) name << 32) | (uint32_t) arity;
+    }
+};
+
+#endif //ROC_LANG_SYMBOLINDEX_H
@@ -0,0 +1,154 @@
+#include "TimeReport.h"
+
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/raw_ostream.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+/**
+ * @return CPU time (user and system) used by the process so far in milliseconds
+ */
+static double processCpuMilliseconds() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+        return 0;
+    }
+    auto toMilliseconds = [](const FILETIME &time) {
+        return (double) (((unsigned long long) time.dwHighDateTime << 32) | time.dwLowDateTime) / 10000.0;
+    };
+    return toMilliseconds(kernel) + toMilliseconds(user);
+#else
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000.0 +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000.0;
+#endif
+}
+
+/**
+ * @return peak resident set size of the process in kilobytes
+ */
+static long long peakRSSKilobytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return (long long) counters.PeakWorkingSetSize / 1024;
+#else
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024; //bytes on macOS
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+TimeReport::Phase::Phase(TimeReport *report, std::string name) : report(report && report->enabled ? report : nullptr),
+                                                                 traced(llvm::timeTraceProfilerEnabled()) {
+    if (this->traced) {
+        llvm::timeTraceProfilerBegin(name, "");
+    }
+    if (!this->report) {
+        return;
+    }
+    CompilePhase phase;
+    phase.name = std::move(name);
+    phase.depth = this->report->depth++;
+    this->index = this->report->phases.size();
+    this->report->phases.push_back(std::move(phase));
+    this->peakRSSStart = peakRSSKilobytes();
+    this->cpuStart = processCpuMilliseconds();
+    this->wallStart = std::chrono::steady_clock::now();
+}
+
+TimeReport::Phase::~Phase() {
+    if (this->traced) {
+        llvm::timeTraceProfilerEnd();
+    }
+    if (!this->report) {
+        return;
+    }
+    auto& phase = this->report->phases[this->index];
+    phase.wallMilliseconds = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - this->wallStart).count();
+    phase.cpuMilliseconds = processCpuMilliseconds() - this->cpuStart;
+    phase.peakRSSDeltaKB = peakRSSKilobytes() - this->peakRSSStart;
+    this->report->depth--;
+}
+
+double TimeReport::totalWallMilliseconds() const {
+    double result = 0;
+    for (auto& phase: phases) {
+        if (phase.depth == 0) {
+            result += phase.wallMilliseconds;
+        }
+    }
+    return result;
+}
+
+void TimeReport::print(llvm::raw_ostream &out) const {
+    out << "phase                             wall ms       cpu ms   peak rss +KB\n";
+    for (auto& phase: phases) {
+        auto name = std::string(phase.depth * 2, ' ') + phase.name;
+        out << llvm::format("%-28s %12.3f %12.3f %14lld\n", name.c_str(), phase.wallMilliseconds,
+                            phase.cpuMilliseconds, phase.peakRSSDeltaKB);
+    }
+    out << llvm::format("total                        %12.3f\n", totalWallMilliseconds());
+}
+
+void TimeReport::printJSON(llvm::raw_ostream &out) const {
+    out << "{\"phases\": [";
+    for (size_t i = 0; i < phases.size(); i++) {
+        auto& phase = phases[i];
+        out << (i == 0 ? "" : ", ") << "{\"name\": \"";
+        out.write_escaped(phase.name);
+        out << "\", \"depth\": " << phase.depth
+            << llvm::format(", \"wallMs\": %.3f, \"cpuMs\": %.3f", phase.wallMilliseconds, phase.cpuMilliseconds)
+            << ", \"peakRssDeltaKb\": " << phase.peakRSSDeltaKB << "}";
+    }
+    out << llvm::format("], \"totalWallMs\": %.3f}\n", totalWallMilliseconds());
+}
+
+bool TimeReport::writeJSON(const std::string &path) const {
+    std::error_code EC;
+    llvm::raw_fd_ostream out(path, EC, llvm::sys::fs::OF_None);
+    if (EC) {
+        return false;
+    }
+    printJSON(out);
+    return true;
+}
+
+TraceSession::TraceSession(std::string path, const std::string &processName) {
+    if (path.empty() || llvm::timeTraceProfilerEnabled()) {
+        return;
+    }
+    this->path = std::move(path);
+    llvm::timeTraceProfilerInitialize(0, processName); //0us granularity keeps spans of small functions
+}
+
+TraceSession::~TraceSession() {
+    if (this->path.empty()) {
+        return;
+    }
+    std::error_code EC;
+    llvm::raw_fd_ostream out(this->path, EC, llvm::sys::fs::OF_None);
+    if (EC) {
+        llvm::errs() << "Could not write trace: " << this->path << "\n";
+    } else {
+        llvm::timeTraceProfilerWrite(out);
+    }
+    llvm::timeTraceProfilerCleanup();
+}
@@ -0,0 +1,106 @@
+#pragma once
+#ifndef ROC_LANG_TIMEREPORT_H
+#define ROC_LANG_TIMEREPORT_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace llvm {
+    class raw_ostream;
+};
+
+/**
+ * Wall time, CPU time and growth of the peak resident set size of a single compiler phase
+ */
+class CompilePhase {
+public:
+    std::string name;
+    int depth = 0; //nested phases i.e. single MIR passes have depth 1
+    double wallMilliseconds = 0;
+    double cpuMilliseconds = 0;
+    long long peakRSSDeltaKB = 0; //0 if the phase did not raise the peak
+};
+
+/**
+ * Collects timings of compiler phases for --time-report, phases are kept in the order they were started
+ */
+class TimeReport {
+public:
+    bool enabled = false;
+    std::vector<CompilePhase> phases;
+
+    /**
+     * Measures the enclosing scope as a phase of given report and as a span of the active trace, does nothing
+     * if neither is enabled
+     */
+    class Phase {
+    private:
+        TimeReport *report;
+        bool traced; //phase is also recorded as a span of the active trace, see TraceSession
+        size_t index = 0;
+        std::chrono::steady_clock::time_point wallStart;
+        double cpuStart = 0;
+        long long peakRSSStart = 0;
+
+    public:
+        Phase(TimeReport *report, std::string name);
+
+        ~Phase();
+
+        Phase(const Phase&) = delete;
+
+        Phase& operator=(const Phase&) = delete;
+    };
+
+    /**
+     * Prints a table with one line per phase
+     */
+    void print(llvm::raw_ostream &out) const;
+
+    /**
+     * Prints phases as JSON object, format: {"phases": [{"name": ..., "depth": ..., "wallMs": ..., "cpuMs": ...,
+     * "peakRssDeltaKb": ...}, ...], "totalWallMs": ...}
+     */
+    void printJSON(llvm::raw_ostream &out) const;
+
+    /**
+     * @return false if the file could not be written
+     */
+    bool writeJSON(const std::string &path) const;
+
+    /**
+     * @return sum of wall time of top level phases
+     */
+    double totalWallMilliseconds() const;
+
+private:
+    int depth = 0;
+};
+
+/**
+ * Records a Chrome trace event file (--trace=<path>) of the compilation in scope. Compiler phases, functions
+ * processed by the resolvers and lowerings and LLVM passes are written as nested spans, the file can be opened
+ * in Perfetto or chrome://tracing
+ */
+class TraceSession {
+private:
+    std::string path;
+
+public:
+    /**
+     * Starts the LLVM time trace profiler unless path is empty or a trace is already recorded
+     */
+    explicit TraceSession(std::string path, const std::string &processName);
+
+    /**
+     * Writes the trace to the file
+     */
+    ~TraceSession();
+
+    TraceSession(const TraceSession&) = delete;
+
+    TraceSession& operator=(const TraceSession&) = delete;
+};
+
+#endif //ROC_LANG_TIMEREPORT_H
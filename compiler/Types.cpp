@@ -5,9 +5,13 @@
 #include "Extensions.h"
 #include "Builtins.h"
 #include "LLVMBackend.h"
+#include "llvm/Support/TimeProfiler.h"
+
+#include <map>
+#include <mutex>
 
 RocPtrType * RocType::getPtrType() {
-    return new RocPtrType(this);
+    return TypeTable::ptrType(this);
 }
 
 static RocTypeNodeContext* createTypeContext(TypeNode* typeNode) {
@@ -33,7 +37,7 @@ static void setType(Expression* expression, RocType* rocType) {
 static RocType* createFromEnum(TypeEnum typeEnum) {
     switch (typeEnum) {
         case int64Type:
-            return new RocInt64Type();
+            return TypeTable::int64Type();
         default:
             throw "Unsupported type enum: " + std::to_string(typeEnum);
     }
@@ -75,7 +79,7 @@ void TypeResolver::visit(Parameter *parameter) {
 }
 
 void TypeResolver::visit(StringNode *stringNode) {
-    createTypeContext(stringNode)->setGivenType(new RocRawStringType(stringNode->getAsStringValue().length()));
+    createTypeContext(stringNode)->setGivenType(TypeTable::rawStringType(stringNode->getAsStringValue().length()));
 }
 
 void TypeResolver::visit(FunctionCallNode *node) {
@@ -86,21 +90,9 @@ void TypeResolver::visit(FunctionCallNode *node) {
     if (node->getParent()->getNodeType() == ElementType::referenceExpression) {
         auto ref = ((ReferenceExpression*) node->getParent())->reference;
         auto refType = getTypeContext(ref)->getGivenType();
-        auto methods = refType->getMethods();
-
-        TargetFunctionCall* tc = nullptr;
-        for (auto& m: methods) {
-            if (m->getName() == node->functionName) {
-                tc = m;
-                break;
-            }
-        }
-        for (auto& m: methods) {
-            if (m != tc) {
-                delete m;
-            }
-        }
-
+        auto tc = this->compilationContext->symbolIndex.findMethod(refType,
+                                                                   node->functionSymbol,
+                                                                   node->argumentList->size());
         if (tc) {
             fc->targetFunctionCall = tc;
             fc->setGivenType(tc->getReturnType());
@@ -130,13 +122,13 @@ void TypeResolver::visit(FunctionVoidReturnTypeNode *functionVoidReturnTypeNode)
     if (!functionVoidReturnTypeNode->typeNode->containsContext(TYPE_CONTEXT)) {
         functionVoidReturnTypeNode->typeNode->addContextHolder(TYPE_CONTEXT, new RocTypeNodeContext());
     }
-    ((RocTypeNodeContext*) functionVoidReturnTypeNode->typeNode->getContextHolder(TYPE_CONTEXT))->setGivenType(new UnitRocType());
+    ((RocTypeNodeContext*) functionVoidReturnTypeNode->typeNode->getContextHolder(TYPE_CONTEXT))->setGivenType(TypeTable::unitType());
 }
 
 void TypeResolver::visit(FunctionNonVoidReturnTypeNode *functionNonVoidReturnTypeNode) {
     functionNonVoidReturnTypeNode->typeNode->accept(this);
     ((RocTypeNodeContext*) functionNonVoidReturnTypeNode->typeNode
-    ->getContextHolder(TYPE_CONTEXT))->setGivenType(getReturnType(functionNonVoidReturnTypeNode->typeNode)->clone());
+    ->getContextHolder(TYPE_CONTEXT))->setGivenType(getReturnType(functionNonVoidReturnTypeNode->typeNode));
 }
 
 void TypeResolver::visit(AddExpr *addExpr) {
@@ -145,7 +137,7 @@ void TypeResolver::visit(AddExpr *addExpr) {
     auto leftType = getReturnType(addExpr->left.get());
     auto rightType = getReturnType(addExpr->right.get());
     if (leftType->isString() && rightType->isString()) {
-        setType(addExpr, leftType->clone());
+        setType(addExpr, leftType);
         return;
     }
     if (leftType->isString() && !rightType->isString()) {
@@ -156,9 +148,9 @@ void TypeResolver::visit(AddExpr *addExpr) {
     }
 
     if (leftType->size() > rightType->size()) {
-        setType(addExpr, leftType->clone());
+        setType(addExpr, leftType);
     } else {
-        setType(addExpr, rightType->clone());
+        setType(addExpr, rightType);
     }
 }
 
@@ -168,16 +160,16 @@ void TypeResolver::visit(SubExpr *subExpr) {
     auto leftType = getReturnType(subExpr->left.get());
     auto rightType = getReturnType(subExpr->right.get());
     if (leftType->size() > rightType->size()) {
-        setType(subExpr,leftType->clone());
+        setType(subExpr,leftType);
     } else {
-        setType(subExpr, rightType->clone());
+        setType(subExpr, rightType);
     }
 }
 
 void TypeResolver::visit(DivExpr *divExpr) {
     ASTVisitor::visit(divExpr);
     createTypeContext(divExpr);
-    setType(divExpr, new RocFloat64Type());
+    setType(divExpr, TypeTable::float64Type());
 }
 
 void TypeResolver::visit(MulExpr *mulExpr) {
@@ -186,9 +178,9 @@ void TypeResolver::visit(MulExpr *mulExpr) {
     auto leftType = getReturnType(mulExpr->left.get());
     auto rightType = getReturnType(mulExpr->right.get());
     if (leftType->size() > rightType->size()) {
-        setType(mulExpr, leftType->clone());
+        setType(mulExpr, leftType);
     } else {
-        setType(mulExpr, rightType->clone());
+        setType(mulExpr, rightType);
     }
 }
 
@@ -198,35 +190,43 @@ void TypeResolver::visit(ModExpr *modExpr) {
     auto leftType = getReturnType(modExpr->left.get());
     auto rightType = getReturnType(modExpr->right.get());
     if (leftType->size() > rightType->size()) {
-        setType(modExpr, leftType->clone());
+        setType(modExpr, leftType);
     } else {
-        setType(modExpr, rightType->clone());
+        setType(modExpr, rightType);
     }
 }
 
 void TypeResolver::visit(EqualOpExpr *opExpr) {
     ASTVisitor::visit(opExpr);
     createTypeContext(opExpr);
-    setType(opExpr, new RocBoolType());
+    setType(opExpr, TypeTable::boolType());
 }
 
 void TypeResolver::visit(SingleTypeNode *node) {
     createTypeContext(node);
-    auto text = node->getText();
-    if (text == "Int64") {
-        setType(node, new RocInt64Type());
-    } else if (text == "Int32" || text == "Int") {
-        setType(node, new RocInt32Type());
-    } else if (text == "Float64") {
-        setType(node, new RocFloat64Type());
-    } else if (text == "Bool") {
-        setType(node, new RocBoolType());
-    } else if (text == "Any") {
-        setType(node, new RocAnyType());
-    } else if (text == "String") {
-        setType(node, new RocStringType());
-    } else {
-        throw CompileTypeException("Could not resolve given type", node, this->compilationContext);
+    auto symbol = node->literal->isLiteral() ? ((Literal*) node->literal)->symbol : noSymbol;
+    switch (symbol) {
+        case roc::symbols::int64Name:
+            setType(node, TypeTable::int64Type());
+            break;
+        case roc::symbols::int32Name:
+        case roc::symbols::intName:
+            setType(node, TypeTable::int32Type());
+            break;
+        case roc::symbols::float64Name:
+            setType(node, TypeTable::float64Type());
+            break;
+        case roc::symbols::boolName:
+            setType(node, TypeTable::boolType());
+            break;
+        case roc::symbols::anyName:
+            setType(node, TypeTable::anyType());
+            break;
+        case roc::symbols::stringName:
+            setType(node, TypeTable::stringType());
+            break;
+        default:
+            throw CompileTypeException("Could not resolve given type", node, this->compilationContext);
     }
 }
 
@@ -234,17 +234,17 @@ void TypeResolver::visit(ArrayTypeNode *arrayTypeNode) {
     auto ctx = createTypeContext(arrayTypeNode);
     arrayTypeNode->singleTypeNode->accept(this);
     auto inner = getReturnType(arrayTypeNode->singleTypeNode.get());
-    ctx->setGivenType(new RocArrayType(inner->clone()));
+    ctx->setGivenType(TypeTable::arrayType(inner));
 }
 
 void TypeResolver::visit(IntNode *intNode) {
     auto ctx = createTypeContext(intNode);
-    ctx->setGivenType(new RocInt32Type());
+    ctx->setGivenType(TypeTable::int32Type());
 }
 
 void TypeResolver::visit(LocalAccess *node) {
     createTypeContext(node);
-    getTypeContext(node)->setGivenType(getReturnType(node->localVariableRef->parameter->typeNode)->clone());
+    getTypeContext(node)->setGivenType(getReturnType(node->localVariableRef->parameter->typeNode));
 }
 
 void TypeResolver::visit(IfExpression* ifExpr) {
@@ -256,6 +256,7 @@ void TypeResolver::visit(IfExpression* ifExpr) {
 }
 
 void TypeResolver::visit(FunctionDeclaration *fd) {
+    llvm::TimeTraceScope traceScope("type resolver", fd->getName()->getText());
     fd->body->accept(this);
 }
 
@@ -286,7 +287,7 @@ void UnitRocType::visit(RocTypeVisitor *visitor) {
 }
 
 RocInt32Type::RocInt32Type() : IntNumberType(TypeEnum::int32Type) {
-    this->matchingTraits.push_back(new RocAnyType());
+    this->matchingTraits.push_back(TypeTable::anyType());
 }
 
 llvm::Type * RocInt32Type::getWrapperType(RocLLVMContext *rocLLVMContext) {
@@ -330,11 +331,11 @@ FunctionSignatureResolver::FunctionSignatureResolver(CompilationContext *compila
 void FunctionSignatureResolver::visit(ModuleDeclaration *moduleDeclaration) {
     compilationContext->pushCompilationNode(moduleDeclaration);
     auto tf = new PredefinedTargetMethodCall(
-                new RocInt32Type(),
+                TypeTable::int32Type(),
                 "toString",
                 "int32ToString",
                 {},
-                new RocPtrType(new RocRawStringType(-1))
+                TypeTable::ptrType(TypeTable::rawStringType(-1))
             );
     compilationContext->insertTargetFunction(tf);
 
@@ -367,7 +368,7 @@ static TargetFunctionCall* findTargetCall(FunctionCallNode *functionCallNode,
                            std::vector<RocType*> callTypes,
                            CompilationContext *compilationContext) {
 
-    auto it = compilationContext->builtinFunctionResolver->functions.find(functionCallNode->getName());
+    auto it = compilationContext->builtinFunctionResolver->functions.find(functionCallNode->functionSymbol);
     if (it != compilationContext->builtinFunctionResolver->functions.end()) {
         for (std::unique_ptr<BuiltinFunction>& f: it->second) {
             int i = 0;
@@ -385,12 +386,11 @@ static TargetFunctionCall* findTargetCall(FunctionCallNode *functionCallNode,
         }
     }
 
-    for (auto& f: compilationContext->moduleStack.back()->functions) {
-        if (f.get()->getName()->getText() == functionCallNode->getName()) {
-            if (f->parameterList->size() == functionCallNode->argumentList->size()) {
-                return ((RocFunctionContext*) f->getContextHolder(TYPE_CONTEXT))->target.get();
-            }
-        }
+    auto function = compilationContext->findFunctionByName(moduleFunctionsTypeId,
+                                                           functionCallNode->functionSymbol,
+                                                           functionCallNode->argumentList->size());
+    if (function) {
+        return function;
     }
 
     if (functionCallNode->getParent()->isDotExpr()) {
@@ -399,7 +399,7 @@ static TargetFunctionCall* findTargetCall(FunctionCallNode *functionCallNode,
         auto typeId = ownerType->typeId();
         auto functionByName = compilationContext->findFunctionByName(
                 typeId,
-                functionCallNode->functionName,
+                functionCallNode->functionSymbol,
                 functionCallNode->argumentList->size());
         return functionByName;
     }
@@ -535,10 +535,6 @@ uint64_t RocPtrType::size() {
     return 8;
 }
 
-RocType *RocPtrType::clone() {
-    return new RocPtrType(this->inner->clone());
-}
-
 int RocPtrType::typeId() {
     return 100;
 }
@@ -569,10 +565,6 @@ uint64_t RocArrayType::size() {
     return 8;
 }
 
-RocType *RocArrayType::clone() {
-    return new RocPtrType(this->inner->clone());
-}
-
 int RocArrayType::typeId() {
     return 200;
 }
@@ -599,12 +591,88 @@ RocType * ArrayTypeResolver::resolve(ArrayCreateExpr *arrayCreateExpr, Compilati
 
         }
     }
-    return type->clone();
+    return type;
 }
 
 std::vector<TargetFunctionCall*> RocAnyType::getMethods() {
     std::vector<TargetFunctionCall*> result;
-    auto ptrType = new RocPtrType(new RocStringType());
+    auto ptrType = TypeTable::ptrType(TypeTable::stringType());
     result.push_back(new PredefinedTargetMethodCall(this, "toString", "Any.toString.0", {}, ptrType));
     return result;
-}
\ No newline at end of file
+}
+UnitRocType* TypeTable::unitType() {
+    static auto type = new UnitRocType();
+    return type;
+}
+
+RocAnyType* TypeTable::anyType() {
+    static auto type = new RocAnyType();
+    return type;
+}
+
+RocBoolType* TypeTable::boolType() {
+    static auto type = new RocBoolType();
+    return type;
+}
+
+RocInt32Type* TypeTable::int32Type() {
+    static auto type = new RocInt32Type();
+    return type;
+}
+
+RocInt64Type* TypeTable::int64Type() {
+    static auto type = new RocInt64Type();
+    return type;
+}
+
+RocFloat64Type* TypeTable::float64Type() {
+    static auto type = new RocFloat64Type();
+    return type;
+}
+
+RocStringType* TypeTable::stringType() {
+    static auto type = new RocStringType();
+    return type;
+}
+
+thread_local TypeTable* TypeTable::active = nullptr;
+
+static std::mutex sharedTypeTableMutex;
+
+/**
+ * @return interned type from the given table of the active TypeTable, created on the first request
+ */
+template<typename K, typename T>
+T* TypeTable::intern(std::map<K, std::unique_ptr<T>> TypeTable::*table, K key) {
+    static TypeTable shared;
+    std::unique_lock<std::mutex> lock(sharedTypeTableMutex, std::defer_lock);
+    auto typeTable = active;
+    if (!typeTable) {
+        lock.lock();
+        typeTable = &shared;
+    }
+    auto& types = typeTable->*table;
+    auto it = types.find(key);
+    if (it != types.end()) {
+        return it->second.get();
+    }
+    auto type = new T(key);
+    types.emplace(key, std::unique_ptr<T>(type));
+    return type;
+}
+
+RocRawStringType* TypeTable::rawStringType(uint64_t length) {
+    return intern(&TypeTable::rawStringTypes, length);
+}
+
+RocPtrType* TypeTable::ptrType(RocType *inner) {
+    return intern(&TypeTable::ptrTypes, inner);
+}
+
+RocArrayType* TypeTable::arrayType(RocType *inner) {
+    return intern(&TypeTable::arrayTypes, inner);
+}
+
+RocWrapperType* TypeTable::wrapperType(RocType *inner) {
+    return intern(&TypeTable::wrapperTypes, inner);
+}
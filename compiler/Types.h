@@ -5,6 +5,8 @@
 #ifndef ROC_LANG_TYPES_H
 #define ROC_LANG_TYPES_H
 
+#include <map>
+#include <memory>
 #include <utility>
 #include <vector>
 #include <string>
@@ -12,7 +14,7 @@
 #include "../parser/Parser.h"
 #include "RocCompiler.h"
 
-static std::string TYPE_CONTEXT = "typeContext";
+static const NodeContextSlot TYPE_CONTEXT = NodeContextSlot::typeContextSlot;
 
 static int rocRawStringTypeId = 2;
 static int rocInt32TypeId = 4;
@@ -56,7 +58,7 @@ enum TypeEnum {
 };
 
 /**
- * Base class for types
+ * Base class for types, instances are interned by TypeTable so two types are equal only if they are the same object
  */
 class RocType {
 public:
@@ -66,11 +68,7 @@ public:
 
     explicit RocType(TypeEnum typeEnum);
 
-    virtual ~RocType() {
-        for (auto& t: matchingTraits) {
-            delete t;
-        }
-    };
+    virtual ~RocType() = default;
 
     virtual llvm::Type* getWrapperType(RocLLVMContext *rocLlvmContext) {
         throw "Unsupported operation";
@@ -82,17 +80,21 @@ public:
 
     virtual std::string internalName() = 0;
 
+    /**
+     * @return true if a value of the other type can be passed where this type is expected
+     */
     virtual bool matches(RocType *other) {
         if (other->isAny()) {
             return true;
         }
-        return this->typeEnum = other->typeEnum;
+        if (this->isAny()) {
+            return other->typeEnum != TypeEnum::unitType;
+        }
+        return this->typeEnum == other->typeEnum;
     }
 
     virtual uint64_t size() = 0;
 
-    virtual RocType* clone() = 0;
-
     virtual int typeId() = 0;
 
     virtual std::string prettyName() = 0;
@@ -140,10 +142,6 @@ public:
     virtual std::vector<RocType *> getMatchingTraits() {
         return matchingTraits;
     }
-
-    virtual bool equals(RocType* other) {
-        return internalName() == other->internalName();
-    }
 };
 
 /**
@@ -155,6 +153,11 @@ public:
         this->varargs = varargs;
     }
 
+protected:
+    explicit RocAnyType(TypeEnum typeEnum) : RocType(typeEnum) { }
+
+public:
+
     void visit(RocTypeVisitor *visitor) override;
 
     std::string toString() override {
@@ -169,10 +172,6 @@ public:
         return 0;
     }
 
-    RocType * clone() override {
-        return new RocAnyType(this->varargs);
-    }
-
     int typeId() override {
         return 1;
     }
@@ -248,10 +247,6 @@ public:
         return length;
     }
 
-    RocType * clone() override {
-        return new RocRawStringType(this->length);
-    }
-
     int typeId() override {
         return rocRawStringTypeId;
     }
@@ -296,10 +291,6 @@ public:
         return 8;
     }
 
-    RocType * clone() override {
-        return new RocStringType();
-    }
-
     int typeId() override {
         return 3;
     }
@@ -340,10 +331,6 @@ public:
         return 0;
     }
 
-    RocType * clone() override {
-        return new UnitRocType();
-    }
-
     int typeId() override {
         return 0;
     }
@@ -376,10 +363,6 @@ public:
         return 1;
     }
 
-    RocType * clone() override {
-        return new RocBoolType();
-    }
-
     int typeId() override {
         return 21;
     }
@@ -392,6 +375,10 @@ public:
         return false;
     }
 
+    bool isAny() override {
+        return false;
+    }
+
     bool isBool() override {
         return true;
     }
@@ -422,10 +409,6 @@ public:
         return 4;
     }
 
-    RocType * clone() override {
-        return new RocInt32Type();
-    }
-
     int typeId() override {
         return rocInt32TypeId;
     }
@@ -456,18 +439,10 @@ public:
         return "i";
     }
 
-    static std::unique_ptr<RocInt32Type> create() {
-        return std::make_unique<RocInt32Type>();
-    }
-
     uint64_t size() override {
         return 8;
     }
 
-    RocType * clone() override {
-        return new RocInt64Type();
-    }
-
     int typeId() override {
         return 5;
     }
@@ -500,10 +475,6 @@ public:
         return 8;
     }
 
-    RocType * clone() override {
-        return new RocFloat64Type();
-    }
-
     int typeId() override {
         return float64TypeId;
     }
@@ -538,10 +509,6 @@ public:
         return inner->size();
     }
 
-    RocType *clone() override {
-        return new RocWrapperType(inner->clone());
-    }
-
     int typeId() override {
         return inner->typeId();
     }
@@ -585,8 +552,6 @@ public:
 
     uint64_t size() override;
 
-    RocType *clone() override;
-
     int typeId() override;
 
     std::string prettyName() override;
@@ -607,10 +572,6 @@ public:
 
     explicit RocArrayType(RocType *inner);
 
-    ~RocArrayType() override {
-        delete inner;
-    }
-
     std::string toString() override;
 
     void visit(RocTypeVisitor *visitor) override;
@@ -619,8 +580,6 @@ public:
 
     uint64_t size() override;
 
-    RocType *clone() override;
-
     int typeId() override;
 
     std::string prettyName() override;
@@ -628,6 +587,77 @@ public:
     llvm::Type *getLLVMType(RocLLVMContext *rocLlvmContext) override;
 };
 
+/**
+ * Interns every Roc type, each distinct type is created once and never changes. Scalar types live until the program
+ * exits, composite types are keyed by their (already interned) inner type and raw strings by their length, they are
+ * owned by the table of the current compilation (see CompilationContext::typeTable) and released with it
+ */
+class TypeTable {
+private:
+    std::map<uint64_t, std::unique_ptr<RocRawStringType>> rawStringTypes;
+    std::map<RocType*, std::unique_ptr<RocPtrType>> ptrTypes;
+    std::map<RocType*, std::unique_ptr<RocArrayType>> arrayTypes;
+    std::map<RocType*, std::unique_ptr<RocWrapperType>> wrapperTypes;
+
+    template<typename K, typename T>
+    static T* intern(std::map<K, std::unique_ptr<T>> TypeTable::*table, K key);
+
+public:
+    /**
+     * Table used for composite types created on the current thread, nullptr if they go to the table shared by
+     * the whole process (guarded by a mutex, used only outside of a compilation i.e. in tests)
+     */
+    static thread_local TypeTable* active;
+
+    /**
+     * Makes given table active for the lifetime of the scope
+     */
+    class Scope {
+    private:
+        TypeTable* previous;
+    public:
+        explicit Scope(TypeTable* typeTable) : previous(active) {
+            active = typeTable;
+        }
+
+        ~Scope() {
+            active = previous;
+        }
+
+        Scope(const Scope&) = delete;
+
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    TypeTable() = default;
+
+    TypeTable(const TypeTable&) = delete;
+
+    TypeTable& operator=(const TypeTable&) = delete;
+
+    static UnitRocType* unitType();
+
+    static RocAnyType* anyType();
+
+    static RocBoolType* boolType();
+
+    static RocInt32Type* int32Type();
+
+    static RocInt64Type* int64Type();
+
+    static RocFloat64Type* float64Type();
+
+    static RocStringType* stringType();
+
+    static RocRawStringType* rawStringType(uint64_t length);
+
+    static RocPtrType* ptrType(RocType *inner);
+
+    static RocArrayType* arrayType(RocType *inner);
+
+    static RocWrapperType* wrapperType(RocType *inner);
+};
+
 /**
  * Context holding type information for TypedASTNode (see in /parser/AST.h file)
  */
@@ -639,11 +669,6 @@ private:
 public:
     RocTypeNodeContext() = default;
 
-    virtual ~RocTypeNodeContext() {
-        delete givenType;
-        delete givenGenericType;
-    }
-
     RocType *getGivenType() const {
         return givenType;
     }
@@ -796,6 +821,20 @@ public:
     virtual std::vector<RocType*> getArgumentTypes() = 0;
 
     virtual RocType* getReturnType() = 0;
+
+    /**
+     * @return true if every call returns a new object referenced only by the caller
+     */
+    virtual bool returnsNewObject() {
+        return false;
+    }
+
+    /**
+     * @return false if the function never references its arguments after it returns
+     */
+    virtual bool keepsArguments() {
+        return true;
+    }
 };
 
 class CompileFunctionException : public SyntaxException {
@@ -1,54 +1,43 @@
 #include <stdio.h>
-#include <unordered_map>
 #include <cstdarg>
-#include <iostream>
 #include "API.h"
-#include <map>
+#include "Allocator.h"
+#include "Format.h"
+#include "Output.h"
 #include <string_view>
 #include <cstring>
+#include <new>
 
 int toStringId = 0;
 int typeIdId = 1;
 
-std::map<INT_64 /* typeId */, ROC_PTR /* vTable ptr */>* vTableMappings = new std::map<INT_64, ROC_PTR>();
-
-void addVTableMapping(INT_64 typeId, ROC_PTR vTablePtr) {
-    vTableMappings->insert({typeId, vTablePtr});
-}
-
-int myIntToString(char* buffer, const char* format, int n) {
-    return sprintf(buffer, format, n);
-}
-
 ROC_PTR myStringRawRTypeToString(StringRawRType* stringRawRType) {
     return (ROC_PTR) stringRawRType;
 }
 
-ROC_PTR myVTableFactory(int count, ...) {
-    va_list args;
-    va_start(args, count);
-    auto vtable = new std::unordered_map<INT_64 /* function Identifier */, FunctionEntry*>();
-    for (int i = 0; i < count; ++i) {
-        auto entry = va_arg(args, FunctionEntry*);
-        vtable->insert({entry->fIdentifier, entry});
-    }
-    va_end(args);
-    return (ROC_PTR) vtable;
+ROC_PTR myGetFunctionPointer(AnyRType *anyRType, INT_64 functionIdentifier) {
+    return ((ROC_PTR*) anyRType->vTable)[functionIdentifier];
 }
 
-ROC_PTR myGetFunctionPointer(AnyRType *anyRType, INT_64 functionIdentifier) {
-    auto vTableIt = vTableMappings->find(anyRType->typeId);
-    if (vTableIt == vTableMappings->end()) {
-        throw std::exception("vTable not initialized for type: " + anyRType->typeId);
-    }
-    //auto vTable = (std::unordered_map<INT_64 /* function Identifier */, FunctionEntry*>*) anyRType->vTable;
-    auto vTable = (std::unordered_map<INT_64, FunctionEntry*>*) vTableIt->second;
-    auto it = vTable->find(functionIdentifier);
-    if (it == vTable->end()) {
-        throw std::exception("Could not find function");
-    } else {
-        auto entry = it->second;
-        return entry->fPtr;
+/**
+ * Writes the content of toString of given object, Int32 values and raw strings are written without calling it
+ */
+static void writeAny(AnyRType* anyT) {
+    switch (anyT->typeId) {
+        case 2: {
+            auto data = ((StringRawRType*) anyT)->data;
+            rocWrite(data, strlen(data));
+            return;
+        }
+        case 4:
+            rocWriteInt32(((Int32RType*) anyT)->value);
+            return;
+        default: {
+            auto fPtr = myGetFunctionPointer(anyT, toStringId);
+            auto fn = (StringRawRType* (*)(AnyRType*)) fPtr;
+            auto data = fn(anyT)->data;
+            rocWrite(data, strlen(data));
+        }
     }
 }
 
@@ -56,12 +45,10 @@ void myPrintln(int count, ...) {
     va_list args;
     va_start(args, count);
     for (int i = 0; i < count; ++i) {
-        auto anyT = va_arg(args, AnyRType*);
-        auto fPtr = myGetFunctionPointer(anyT, toStringId);
-        auto fn = (StringRawRType* (*)(AnyRType*)) fPtr;
-        std::cout << fn(anyT)->data << " ";
+        writeAny(va_arg(args, AnyRType*));
+        rocWrite(" ", 1);
     }
-    std::cout << std::endl;
+    rocWrite("\n", 1);
     va_end(args);
 }
 
@@ -69,51 +56,84 @@ void myPrint(int count, ...) {
     va_list args;
     va_start(args, count);
     for (int i = 0; i < count; ++i) {
-        auto anyT = va_arg(args, AnyRType*);
-        auto fPtr = myGetFunctionPointer(anyT, toStringId);
-        auto fn = (StringRawRType* (*)(AnyRType*)) fPtr;
-        std::cout << fn(anyT)->data;
+        writeAny(va_arg(args, AnyRType*));
     }
     va_end(args);
 }
 
-long long myInt32ToString(int n) {
-    auto result = new StringRawRType();
-    auto buffer = new char[12];
-    auto length = sprintf(buffer, "%d", n);
+/**
+ * Size of a raw string converted from Int32, its chars are allocated in the same block right after the header
+ */
+static constexpr INT_64 int32StringSize = sizeof(StringRawRType) + ROC_INT32_MAX_CHARS + 1;
+
+static_assert(int32StringSize <= ROC_MAX_SMALL_SIZE, "converted Int32 should fit a single size class");
+static_assert(sizeof(StringRawRType) % ROC_SIZE_CLASS_STEP != 0, "chars after the header should not look allocated");
+
+//virtual tables are constant globals of the compiled module, generated code passes their addresses
+long long myInt32ToString(int n, ROC_PTR stringRawVTable) {
+    auto result = new (rocAlloc(int32StringSize)) StringRawRType();
+    auto buffer = (char*) (result + 1);
+    auto length = rocFormatInt32(buffer, n);
+    buffer[length] = 0;
     result->length = length;
     result->data = buffer;
     result->refC = 1;
     result->typeId = 2;
-    result->vTable = vTableMappings->find(2)->second;
+    result->vTable = stringRawVTable;
     return (ROC_PTR) result;
 }
 
-ROC_PTR myWrapCharPtr(char* rawString) {
-    auto result = new StringRawRType();
+ROC_PTR myWrapCharPtr(char* rawString, ROC_PTR stringRawVTable) {
+    auto result = new (rocAlloc(sizeof(StringRawRType))) StringRawRType();
     result->data = rawString;
     result->refC = 1;
     result->typeId = 2;
+    result->vTable = stringRawVTable;
     return (ROC_PTR) result;
 }
 
-void myInitRawString(StringRawRType* stringRawRType, char* rawString, int length) {
+void myInitRawString(StringRawRType* stringRawRType, char* rawString, int length, ROC_PTR vTable) {
     stringRawRType->data = rawString;
     stringRawRType->typeId = 2;
+    stringRawRType->vTable = vTable;
     stringRawRType->refC = 1;
     stringRawRType->length = length;
 }
 
-void myInitInt32(Int32RType* int32RType, int value) {
+void myInitInt32(Int32RType* int32RType, int value, ROC_PTR vTable) {
     int32RType->value = value;
     int32RType->typeId = 4;
+    int32RType->vTable = vTable;
     int32RType->refC = 1;
 }
 
+/**
+ * @return size of the block holding given runtime object, 0 for types without heap allocated objects
+ */
+static INT_64 objectSize(AnyRType* any) {
+    switch (any->typeId) {
+        case 2: {
+            //chars right after the header come from myInt32ToString, rocAlloc never returns an address like that
+            auto stringRawRType = (StringRawRType*) any;
+            return stringRawRType->data == (char*) (stringRawRType + 1) ? int32StringSize : sizeof(StringRawRType);
+        }
+        case 4:
+            return sizeof(Int32RType);
+        default:
+            return 0;
+    }
+}
+
 void myDecr(AnyRType* any) {
+    if (any->refC == ROC_IMMORTAL_REFC) {
+        return; //immortal objects may live in read only memory
+    }
     any->refC = any->refC - 1;
     if (any->refC <= 0) {
-        delete any;
+        auto size = objectSize(any);
+        if (size) {
+            rocFree(any, size);
+        }
     }
 }
 
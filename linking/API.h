@@ -8,8 +8,18 @@
 typedef long long INT_64;
 typedef long long ROC_PTR;
 
+/**
+ * Number of slots in a virtual table. Slot indices are the method ids from roc::methods
+ */
+#define ROC_VTABLE_SIZE 4
+
+/**
+ * Reference counter of immortal objects (i.e. cached boxed Int32 values), reference counting skips them
+ */
+#define ROC_IMMORTAL_REFC 0x7FFFFFFFFFFFFFFFLL
+
 struct AnyRType {
-    ROC_PTR vTable; //pointer to virtual table
+    ROC_PTR vTable; //pointer to virtual table (flat array of ROC_VTABLE_SIZE function pointers)
     INT_64 typeId; //type id
     INT_64 refC; //reference counter
 };
@@ -42,25 +52,20 @@ struct Int32ArrayRType : public ArrayRType {
     int* elements;
 };
 
-extern "C" void addVTableMapping(long long typeId, long long vTablePtr);
-
-extern "C" int myIntToString(char* buffer, const char* format, int s);
 
 extern "C" ROC_PTR myStringRawRTypeToString(StringRawRType* stringRawRType);
 
-extern "C" ROC_PTR myVTableFactory(int count, ...);
-
 extern "C" ROC_PTR myGetFunctionPointer(AnyRType *anyRType, long long functionIdentifier);
 
 extern "C" void myPrintln(int count, ...);
 
 extern "C" void myPrint(int count, ...);
 
-extern "C" ROC_PTR myInt32ToString(int n);
+extern "C" ROC_PTR myInt32ToString(int n, ROC_PTR stringRawVTable);
 
-extern "C" void myInitRawString(StringRawRType* stringRawRType, char* rawString, int length);
+extern "C" void myInitRawString(StringRawRType* stringRawRType, char* rawString, int length, ROC_PTR vTable);
 
-extern "C" void myInitInt32(Int32RType* int32RType, int value);
+extern "C" void myInitInt32(Int32RType* int32RType, int value, ROC_PTR vTable);
 
 extern "C" void myDecr(AnyRType *any);
 
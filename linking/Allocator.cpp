@@ -0,0 +1,75 @@
+#include "Allocator.h"
+#include <cstdlib>
+
+static const int sizeClassCount = ROC_MAX_SMALL_SIZE / ROC_SIZE_CLASS_STEP;
+
+struct FreeBlock {
+    FreeBlock* next;
+};
+
+/**
+ * Free lists and current slabs of one thread, a block freed by another thread joins the list of that thread
+ */
+struct ThreadPool {
+    FreeBlock* freeLists[sizeClassCount] = {};
+    char* slabs[sizeClassCount] = {}; //unused rest of the current slab of every size class
+    INT_64 remaining[sizeClassCount] = {};
+    INT_64 liveBlocks = 0; //small blocks allocated and not yet freed by this thread
+};
+
+static thread_local ThreadPool threadPool;
+
+static int sizeClassOf(INT_64 size) {
+    return (int) ((size + ROC_SIZE_CLASS_STEP - 1) / ROC_SIZE_CLASS_STEP) - 1;
+}
+
+static void* allocateFromSlab(ThreadPool& pool, int sizeClass) {
+    INT_64 blockSize = (sizeClass + 1) * ROC_SIZE_CLASS_STEP;
+    if (pool.remaining[sizeClass] < blockSize) {
+        pool.slabs[sizeClass] = (char*) std::malloc(ROC_SLAB_SIZE); //malloc alignment covers ROC_SIZE_CLASS_STEP
+        if (!pool.slabs[sizeClass]) {
+            pool.remaining[sizeClass] = 0;
+            return nullptr;
+        }
+        pool.remaining[sizeClass] = ROC_SLAB_SIZE;
+    }
+    auto result = pool.slabs[sizeClass];
+    pool.slabs[sizeClass] += blockSize;
+    pool.remaining[sizeClass] -= blockSize;
+    return result;
+}
+
+void* rocAlloc(INT_64 size) {
+    if (size > ROC_MAX_SMALL_SIZE) {
+        return std::malloc(size);
+    }
+    auto sizeClass = sizeClassOf(size <= 0 ? 1 : size);
+    auto& pool = threadPool;
+    pool.liveBlocks++;
+    auto block = pool.freeLists[sizeClass];
+    if (block) {
+        pool.freeLists[sizeClass] = block->next;
+        return block;
+    }
+    return allocateFromSlab(pool, sizeClass);
+}
+
+void rocFree(void* ptr, INT_64 size) {
+    if (!ptr) {
+        return;
+    }
+    if (size > ROC_MAX_SMALL_SIZE) {
+        std::free(ptr);
+        return;
+    }
+    auto sizeClass = sizeClassOf(size <= 0 ? 1 : size);
+    auto& pool = threadPool;
+    pool.liveBlocks--;
+    auto block = (FreeBlock*) ptr;
+    block->next = pool.freeLists[sizeClass];
+    pool.freeLists[sizeClass] = block;
+}
+
+INT_64 rocLiveSmallBlocks() {
+    return threadPool.liveBlocks;
+}
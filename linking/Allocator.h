@@ -0,0 +1,40 @@
+#pragma once
+#ifndef ROC_LANG_ALLOCATOR_H
+#define ROC_LANG_ALLOCATOR_H
+
+#include "API.h"
+
+/**
+ * Granularity of size classes, every small allocation is rounded up to a multiple of it
+ */
+#define ROC_SIZE_CLASS_STEP 16
+
+/**
+ * Largest allocation served from slabs (headers of Int32RType, StringRawRType, ArrayRType, short string data),
+ * bigger ones go to malloc
+ */
+#define ROC_MAX_SMALL_SIZE 64
+
+/**
+ * Size of a slab carved into objects of one size class
+ */
+#define ROC_SLAB_SIZE (64 * 1024)
+
+/**
+ * Allocates runtime memory, used by the generated code (instead of malloc) and the API. Small sizes come from
+ * per-thread free lists of size-class slabs, the memory is aligned to ROC_SIZE_CLASS_STEP
+ */
+extern "C" void* rocAlloc(INT_64 size);
+
+/**
+ * Releases memory of rocAlloc, size must be the one given to rocAlloc. Small blocks are put on the free list of
+ * the calling thread, slabs are never returned to the system
+ */
+extern "C" void rocFree(void* ptr, INT_64 size);
+
+/**
+ * @return number of small blocks allocated and not freed by the calling thread, used to find leaks in tests
+ */
+extern "C" INT_64 rocLiveSmallBlocks();
+
+#endif //ROC_LANG_ALLOCATOR_H
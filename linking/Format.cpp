@@ -0,0 +1,62 @@
+#include "Format.h"
+#include <charconv>
+#include <cstring>
+
+static const char digitPairs[201] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+
+static int digitCount(unsigned long long n) {
+    int count = 1;
+    while (n >= 10000) {
+        n /= 10000;
+        count += 4;
+    }
+    if (n >= 1000) return count + 3;
+    if (n >= 100) return count + 2;
+    if (n >= 10) return count + 1;
+    return count;
+}
+
+static int formatUnsigned(char* buffer, unsigned long long n) {
+    auto count = digitCount(n);
+    auto position = buffer + count;
+    while (n >= 100) {
+        auto pair = (n % 100) * 2;
+        n /= 100;
+        position -= 2;
+        std::memcpy(position, digitPairs + pair, 2);
+    }
+    if (n >= 10) {
+        std::memcpy(position - 2, digitPairs + n * 2, 2);
+    } else {
+        *(position - 1) = (char) ('0' + n);
+    }
+    return count;
+}
+
+int rocFormatInt32(char* buffer, int n) {
+    return rocFormatInt64(buffer, n);
+}
+
+int rocFormatInt64(char* buffer, INT_64 n) {
+    if (n < 0) {
+        *buffer = '-';
+        //negated as unsigned, so the minimal value does not overflow
+        return formatUnsigned(buffer + 1, 0ULL - (unsigned long long) n) + 1;
+    }
+    return formatUnsigned(buffer, (unsigned long long) n);
+}
+
+int rocFormatFloat64(char* buffer, double n) {
+    auto result = std::to_chars(buffer, buffer + ROC_FLOAT64_MAX_CHARS, n);
+    return (int) (result.ptr - buffer);
+}
@@ -0,0 +1,36 @@
+#pragma once
+#ifndef ROC_LANG_FORMAT_H
+#define ROC_LANG_FORMAT_H
+
+#include "API.h"
+
+/**
+ * Longest decimal forms written by the formatters: "-2147483648", "-9223372036854775808" and
+ * "-2.2250738585072014e-308" (shortest round trip form)
+ */
+#define ROC_INT32_MAX_CHARS 11
+#define ROC_INT64_MAX_CHARS 20
+#define ROC_FLOAT64_MAX_CHARS 24
+
+/**
+ * Writes decimal form of n to buffer (two digits per step from a table of digit pairs), without a terminating zero
+ *
+ * @return number of written chars, at most ROC_INT32_MAX_CHARS
+ */
+extern "C" int rocFormatInt32(char* buffer, int n);
+
+/**
+ * Same as rocFormatInt32 for 64 bit values
+ *
+ * @return number of written chars, at most ROC_INT64_MAX_CHARS
+ */
+extern "C" int rocFormatInt64(char* buffer, INT_64 n);
+
+/**
+ * Writes the shortest decimal form of n that reads back to the same value, without a terminating zero
+ *
+ * @return number of written chars, at most ROC_FLOAT64_MAX_CHARS
+ */
+extern "C" int rocFormatFloat64(char* buffer, double n);
+
+#endif //ROC_LANG_FORMAT_H
@@ -0,0 +1,161 @@
+#include "Output.h"
+#include "Format.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#define ROC_WRITE _write
+#define ROC_ISATTY _isatty
+#else
+#include <unistd.h>
+#define ROC_WRITE write
+#define ROC_ISATTY isatty
+#endif
+
+/**
+ * Output buffer of the runtime, shared by all threads
+ */
+struct OutputBuffer {
+    std::mutex mutex;
+    std::vector<char> data;
+    size_t used = 0;
+    int mode = ROC_OUTPUT_FULLY_BUFFERED;
+    bool initialized = false;
+};
+
+static OutputBuffer& outputBuffer() {
+    static auto buffer = new OutputBuffer(); //never destroyed, so it outlives flushes at exit
+    return *buffer;
+}
+
+static void writeAll(const char* data, size_t length) {
+    while (length > 0) {
+        auto written = ROC_WRITE(1, data, (unsigned int) length);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return; //nowhere to report it, the output is dropped like with a failed std::cout
+        }
+        data += written;
+        length -= written;
+    }
+}
+
+static void flushLocked(OutputBuffer& buffer) {
+    writeAll(buffer.data.data(), buffer.used);
+    buffer.used = 0;
+}
+
+static void flushAtExit() {
+    rocFlush();
+}
+
+static void initialize(OutputBuffer& buffer) {
+    buffer.initialized = true;
+    buffer.mode = ROC_ISATTY(1) ? ROC_OUTPUT_LINE_BUFFERED : ROC_OUTPUT_FULLY_BUFFERED;
+    auto mode = std::getenv("ROC_OUTPUT_BUFFERING");
+    if (mode) {
+        if (std::strcmp(mode, "none") == 0) {
+            buffer.mode = ROC_OUTPUT_UNBUFFERED;
+        } else if (std::strcmp(mode, "line") == 0) {
+            buffer.mode = ROC_OUTPUT_LINE_BUFFERED;
+        } else if (std::strcmp(mode, "full") == 0) {
+            buffer.mode = ROC_OUTPUT_FULLY_BUFFERED;
+        }
+    }
+    INT_64 size = ROC_OUTPUT_BUFFER_SIZE;
+    auto sizeText = std::getenv("ROC_OUTPUT_BUFFER_SIZE");
+    if (sizeText && std::atoll(sizeText) > 0) {
+        size = std::atoll(sizeText);
+    }
+    buffer.data.resize(size);
+    std::atexit(flushAtExit);
+}
+
+void rocWrite(const char* data, INT_64 length) {
+    auto& buffer = outputBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    if (!buffer.initialized) {
+        initialize(buffer);
+    }
+    if (buffer.mode == ROC_OUTPUT_UNBUFFERED) {
+        writeAll(data, length);
+        return;
+    }
+    if (buffer.used + length > buffer.data.size()) {
+        flushLocked(buffer);
+        if ((size_t) length >= buffer.data.size()) {
+            writeAll(data, length);
+            return;
+        }
+    }
+    std::memcpy(buffer.data.data() + buffer.used, data, length);
+    buffer.used += length;
+    if (buffer.mode == ROC_OUTPUT_LINE_BUFFERED && std::memchr(data, '\n', length)) {
+        flushLocked(buffer);
+    }
+}
+
+/**
+ * Formats a value of at most maxChars chars in place at the end of the buffer
+ */
+template<typename Formatter>
+static void writeFormatted(size_t maxChars, Formatter format) {
+    auto& buffer = outputBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    if (!buffer.initialized) {
+        initialize(buffer);
+    }
+    if (buffer.mode == ROC_OUTPUT_UNBUFFERED || buffer.data.size() < maxChars) {
+        char chars[ROC_FLOAT64_MAX_CHARS];
+        auto length = format(chars);
+        if (buffer.mode != ROC_OUTPUT_UNBUFFERED && buffer.used + length <= buffer.data.size()) {
+            std::memcpy(buffer.data.data() + buffer.used, chars, length);
+            buffer.used += length;
+            return;
+        }
+        flushLocked(buffer);
+        writeAll(chars, length);
+        return;
+    }
+    if (buffer.used + maxChars > buffer.data.size()) {
+        flushLocked(buffer);
+    }
+    buffer.used += format(buffer.data.data() + buffer.used);
+}
+
+void rocWriteInt32(int n) {
+    writeFormatted(ROC_INT32_MAX_CHARS, [n](char* chars) { return rocFormatInt32(chars, n); });
+}
+
+void rocWriteInt64(INT_64 n) {
+    writeFormatted(ROC_INT64_MAX_CHARS, [n](char* chars) { return rocFormatInt64(chars, n); });
+}
+
+void rocWriteFloat64(double n) {
+    writeFormatted(ROC_FLOAT64_MAX_CHARS, [n](char* chars) { return rocFormatFloat64(chars, n); });
+}
+
+void rocFlush() {
+    auto& buffer = outputBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    flushLocked(buffer);
+}
+
+void rocSetOutputBuffering(int mode, INT_64 size) {
+    auto& buffer = outputBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    if (!buffer.initialized) {
+        initialize(buffer);
+    }
+    flushLocked(buffer);
+    buffer.mode = mode;
+    if (size > 0) {
+        buffer.data.resize(size);
+    }
+}
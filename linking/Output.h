@@ -0,0 +1,45 @@
+#pragma once
+#ifndef ROC_LANG_OUTPUT_H
+#define ROC_LANG_OUTPUT_H
+
+#include "API.h"
+
+/**
+ * Buffering policies of the runtime output, picked by ROC_OUTPUT_BUFFERING=none|line|full or rocSetOutputBuffering.
+ * Without either, output to a terminal is line buffered and other output is fully buffered
+ */
+#define ROC_OUTPUT_UNBUFFERED 0
+#define ROC_OUTPUT_LINE_BUFFERED 1
+#define ROC_OUTPUT_FULLY_BUFFERED 2
+
+/**
+ * Default size of the output buffer, ROC_OUTPUT_BUFFER_SIZE=<bytes> overrides it
+ */
+#define ROC_OUTPUT_BUFFER_SIZE (64 * 1024)
+
+/**
+ * Writes to the standard output (fd 1) through the runtime buffer, bypassing iostreams. The buffer is flushed
+ * when full, after a new line if line buffered, on rocFlush and at exit
+ */
+extern "C" void rocWrite(const char* data, INT_64 length);
+
+/**
+ * Write decimal form of n (see rocFormatInt32, rocFormatInt64, rocFormatFloat64) straight into the output buffer
+ */
+extern "C" void rocWriteInt32(int n);
+
+extern "C" void rocWriteInt64(INT_64 n);
+
+extern "C" void rocWriteFloat64(double n);
+
+/**
+ * Writes buffered output to fd 1, called by the flush() builtin
+ */
+extern "C" void rocFlush();
+
+/**
+ * Flushes pending output and sets the buffering policy (ROC_OUTPUT_*), size <= 0 keeps the current buffer size
+ */
+extern "C" void rocSetOutputBuffering(int mode, INT_64 size);
+
+#endif //ROC_LANG_OUTPUT_H
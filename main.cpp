@@ -1,43 +1,153 @@
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
-#include <fstream>
-#include <streambuf>
 
 #include "compiler/RocCompiler.h"
+#include "parser/SourceBuffer.h"
+#include "passes/PassManager.h"
+#include "linking/Output.h"
+
+/**
+ * Parses whole text as a decimal number in the range of min..max
+ *
+ * @return false for empty, malformed or out of range text
+ */
+static bool parseNumber(const std::string& text, long long min, long long max, long long& result) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end;
+    errno = 0;
+    auto value = std::strtoll(text.c_str(), &end, 10);
+    if (errno != 0 || *end != '\0' || value < min || value > max) {
+        return false;
+    }
+    result = value;
+    return true;
+}
 
 int main(int argc, char **argv) {
-    if (argc != 2) {
+    Config config;
+    config.outputMode = emitAsm;
+    std::string asStr;
+    int outputBuffering = -1; //policy of ROC_OUTPUT_BUFFERING or the default one
+    long long outputBufferSize = 0;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg(argv[i]);
+        if (arg.size() == 3 && arg.rfind("-O", 0) == 0 && arg[2] >= '0' && arg[2] <= '3') {
+            config.optimizationLevel = arg[2] - '0';
+        } else if (arg == "-o" && i + 1 < argc) {
+            config.srcOutput = argv[++i];
+        } else if (arg.rfind("--mcpu=", 0) == 0) {
+            config.targetCpu = arg.substr(7);
+        } else if (arg.rfind("--mattr=", 0) == 0) {
+            config.targetFeatures = arg.substr(8);
+        } else if (arg.rfind("--mir-passes=", 0) == 0) {
+            config.mirPasses = arg.substr(13);
+        } else if (arg == "--verify-mir") {
+            config.verifyMIR = true;
+        } else if (arg == "--time-mir-passes") {
+            config.timeMIRPasses = true;
+        } else if (arg == "--time-report") {
+            config.timeReport = true;
+        } else if (arg.rfind("--time-report=", 0) == 0) {
+            config.timeReportJSON = arg.substr(14);
+        } else if (arg == "--emit=asm") {
+            config.outputMode = emitAsm;
+        } else if (arg == "--emit=obj") {
+            config.outputMode = emitObj;
+        } else if (arg == "--emit=ir") {
+            config.outputMode = emitIR;
+        } else if (arg == "--emit=jit") {
+            config.outputMode = jitRun;
+        } else if (arg.rfind("--int32-cache=", 0) == 0) {
+            auto range = arg.substr(14);
+            auto comma = range.find(',');
+            long long cacheMin, cacheMax;
+            if (comma == std::string::npos ||
+                !parseNumber(range.substr(0, comma), INT32_MIN, INT32_MAX, cacheMin) ||
+                !parseNumber(range.substr(comma + 1), INT32_MIN, INT32_MAX, cacheMax) ||
+                cacheMax - cacheMin >= Config::int32CacheLimit) {
+                std::cerr << "Expected --int32-cache=<min>,<max> with at most " << Config::int32CacheLimit
+                          << " values";
+                return 1;
+            }
+            config.int32CacheMin = (int) cacheMin;
+            config.int32CacheMax = (int) cacheMax;
+        } else if (arg.rfind("--output-buffering=", 0) == 0) {
+            auto policy = arg.substr(19);
+            auto comma = policy.find(',');
+            bool validSize = true;
+            if (comma != std::string::npos) {
+                //buffer is allocated up front, so its size is limited to 1 GiB
+                validSize = parseNumber(policy.substr(comma + 1), 1, 1LL << 30, outputBufferSize);
+                policy = policy.substr(0, comma);
+            }
+            if (!validSize) {
+                std::cerr << "Expected --output-buffering=none|line|full[,<bytes>]";
+                return 1;
+            } else if (policy == "none") {
+                outputBuffering = ROC_OUTPUT_UNBUFFERED;
+            } else if (policy == "line") {
+                outputBuffering = ROC_OUTPUT_LINE_BUFFERED;
+            } else if (policy == "full") {
+                outputBuffering = ROC_OUTPUT_FULLY_BUFFERED;
+            } else {
+                std::cerr << "Expected --output-buffering=none|line|full[,<bytes>]";
+                return 1;
+            }
+        } else if (arg.rfind("--trace=", 0) == 0) {
+            config.traceFile = arg.substr(8);
+        } else if (arg.rfind("-", 0) == 0) {
+            std::cerr << "Unknown option: " << arg;
+            return 1;
+        } else if (asStr.empty()) {
+            asStr = arg;
+        } else {
+            std::cerr << "Expected single input file";
+            return 1;
+        }
+    }
+
+    try {
+        MIRPassManager().addPasses(config.mirPasses);
+    } catch (std::exception &ex) {
+        std::cerr << ex.what();
+        return 1;
+    }
+
+    if (asStr.empty()) {
         std::cerr << "Expected input file";
         return 1;
     }
-    char* toCompile = argv[1];
-    std::string asStr = std::string(toCompile);
 
     if(asStr.substr(asStr.find_last_of(".") + 1) != "roc") {
         std::cerr << "Expected input Roc lang file";
         return 1;
     }
 
-    std::string line;
-    std::ifstream f(asStr);
+    auto source = SourceBuffer::fromFile(asStr);
 
-    if (!f.good()) {
+    if (!source) {
         std::cerr << "Input file does not exist";
         return 1;
     }
 
-    std::string acc;
+    auto result = RocCompiler::compileSource(source, asStr, config);
 
-    if (f.is_open())
-    {
-        while (getline(f, line))
-        {
-            if (!acc.empty()) acc+='\n';
-            acc+=line;
+    if (result && config.outputMode == jitRun) {
+        if (!result->mainFunctionPtr) {
+            std::cerr << "Expected main function";
+            return 1;
+        }
+        if (outputBuffering != -1) {
+            rocSetOutputBuffering(outputBuffering, outputBufferSize);
         }
-        f.close();
+        ((void (*)()) result->mainFunctionPtr)();
+        rocFlush();
     }
 
-    RocCompiler::compile(acc, "output.s");
-
-    return 0;
+    return result ? 0 : 1;
 }
@@ -3,9 +3,69 @@
 //
 #include "MIR.h"
 #include "../compiler/Extensions.h"
+#include "llvm/Support/TimeProfiler.h"
 
 #include <utility>
 
+/**
+ * Header in front of every MIR node: owning arena (nullptr for heap) and whether the node was already destroyed
+ */
+struct MIRNodeHeader {
+    Arena* arena;
+    bool destroyed;
+};
+
+static constexpr size_t mirHeaderSize = alignof(std::max_align_t);
+
+static_assert(sizeof(MIRNodeHeader) <= mirHeaderSize, "MIR node header doesn't fit");
+
+static void* allocateMIRNode(size_t size, void (*destroy)(void*)) {
+    auto arena = Arena::active;
+    auto header = (MIRNodeHeader*) (arena ? arena->allocate(size + mirHeaderSize)
+                                          : ::operator new(size + mirHeaderSize));
+    header->arena = arena;
+    header->destroyed = false;
+    if (arena) {
+        arena->addFinalizer(header, destroy);
+    }
+    return (char*) header + mirHeaderSize;
+}
+
+static void deallocateMIRNode(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    auto header = (MIRNodeHeader*) ((char*) ptr - mirHeaderSize);
+    if (header->arena) {
+        header->destroyed = true; //storage stays with the arena
+    } else {
+        ::operator delete(header);
+    }
+}
+
+template<typename T>
+static void destroyMIRNode(void* header) {
+    if (!((MIRNodeHeader*) header)->destroyed) {
+        ((T*) ((char*) header + mirHeaderSize))->~T();
+    }
+}
+
+void* MIRValue::operator new(size_t size) {
+    return allocateMIRNode(size, destroyMIRNode<MIRValue>);
+}
+
+void MIRValue::operator delete(void* ptr) {
+    deallocateMIRNode(ptr);
+}
+
+void* MIRLabel::operator new(size_t size) {
+    return allocateMIRNode(size, destroyMIRNode<MIRLabel>);
+}
+
+void MIRLabel::operator delete(void* ptr) {
+    deallocateMIRNode(ptr);
+}
+
 void forEachChildren(std::vector<std::unique_ptr<Expression>> *children, ToMIRVisitor *toMIRVisitor) {
     for (auto& ch: *children) {
         ch->accept(toMIRVisitor);
@@ -48,12 +108,113 @@ void MIRModule::visit(MIRVisitor *mirVisitor) {
 }
 
 MIRBlock::MIRBlock(std::string name,
-                   std::vector<MIRValue*> values) : MIRValue(), name(std::move(name)), values(std::move(values)) {}
+                   std::vector<MIRValue*> values) : MIRValue(), name(std::move(name)), values(std::move(values)) {
+    for (auto& v: this->values) {
+        v->parent = this;
+    }
+}
+
+/**
+ * Replaces an element of given vector, used by nodes holding lists of children
+ */
+void replaceInVector(std::vector<MIRValue*>& values, MIRValue *old, MIRValue *with, MIRValue *parent) {
+    for (auto& v: values) {
+        if (v == old) {
+            v = with;
+            with->parent = parent;
+            return;
+        }
+    }
+    throw "Could not find child to replace";
+}
+
+void MIRBlock::replaceChild(MIRValue *old, MIRValue *with) {
+    replaceInVector(this->values, old, with, this);
+}
+
+void MIRFunctionCall::replaceChild(MIRValue *old, MIRValue *with) {
+    replaceInVector(this->arguments, old, with, this);
+}
+
+void MIRFunctionInstanceCall::replaceChild(MIRValue *old, MIRValue *with) {
+    if (this->caller == old) {
+        this->caller = with;
+        with->parent = this;
+        return;
+    }
+    MIRFunctionCall::replaceChild(old, with);
+}
+
+void MIRBinOpBase::replaceChild(MIRValue *old, MIRValue *with) {
+    if (this->left == old) {
+        this->left = with;
+    } else if (this->right == old) {
+        this->right = with;
+    } else {
+        throw "Could not find child to replace";
+    }
+    with->parent = this;
+}
+
+void MIRCondition::replaceChild(MIRValue *old, MIRValue *with) {
+    this->expr = with;
+    with->parent = this;
+}
+
+void MIRReturnValue::replaceChild(MIRValue *old, MIRValue *with) {
+    this->value = with;
+    with->parent = this;
+}
+
+void MIRToPtr::replaceChild(MIRValue *old, MIRValue *with) {
+    this->expr = with;
+    with->parent = this;
+}
+
+void MIRToWrapper::replaceChild(MIRValue *old, MIRValue *with) {
+    this->expr = with;
+    with->parent = this;
+}
+
+void MIRCastTo::replaceChild(MIRValue *old, MIRValue *with) {
+    this->from = with;
+    with->parent = this;
+}
+
+void MIRInt32Array::replaceChild(MIRValue *old, MIRValue *with) {
+    replaceInVector(this->elements, old, with, this);
+}
 
 void MIRBlock::accept(MIRVisitor *mirVisitor) {
     mirVisitor->visit(this);
 }
 
+void MIRBasicBlock::accept(MIRVisitor *mirVisitor) {
+    mirVisitor->visit(this);
+}
+
+std::vector<MIRValue*> MIRBasicBlock::getChildren() {
+    auto result = this->values;
+    if (this->condition) {
+        result.push_back(this->condition);
+    }
+    return result;
+}
+
+void MIRBasicBlock::replaceChild(MIRValue *old, MIRValue *with) {
+    replaceInVector(this->values, old, with, this);
+}
+
+bool MIRBasicBlock::dominates(MIRBasicBlock *block) {
+    if (this->order == -1 || block->order == -1) {
+        return false;
+    }
+    while (block != nullptr && block != this) {
+        block = block->immediateDominator;
+    }
+    return block == this;
+}
+
 void MIRTrue::accept(MIRVisitor *mirVisitor) {
     mirVisitor->visitTrue(this);
 }
@@ -79,16 +240,17 @@ void ToMIRVisitor::visit(StaticBlock *staticBlock) {
     this->valueStack.push_back(new MIRReturnValue(new MIRConstantInt(0)));
     auto block = new MIRBlock("entry", std::move(this->valueStack));
     this->valueStack.clear();
-    auto returnType = new MIRTypeDecl(new RocInt32Type());
+    auto returnType = new MIRTypeDecl(TypeTable::int32Type());
     std::vector<MIRFunctionParameter*> parameters;
     this->functionStack.push_back(std::make_unique<MIRFunction>("main", std::move(parameters), returnType, block));
 }
 
 void ToMIRVisitor::visit(FunctionDeclaration *fd) {
+    llvm::TimeTraceScope traceScope("to MIR", fd->getName()->getText());
     std::vector<MIRFunctionParameter*> params;
     for (auto& p :fd->parameterList->parameters) {
         auto paramType = ((RocTypeNodeContext*) p->typeNode->getContextHolder(TYPE_CONTEXT))->getGivenType();
-        params.push_back(new MIRFunctionParameter(p->name->getText(), new MIRTypeDecl(paramType->clone())));
+        params.push_back(new MIRFunctionParameter(p->name->getText(), new MIRTypeDecl(paramType)));
     }
 
     for (auto& exp :fd->body->expressions) {
@@ -99,7 +261,7 @@ void ToMIRVisitor::visit(FunctionDeclaration *fd) {
     if (fd->functionReturnTypeNode) {
         returnType = new MIRTypeDecl(((RocTypeNodeContext*) fd->functionReturnTypeNode->typeNode->getContextHolder(TYPE_CONTEXT))->getGivenType());
     } else {
-        returnType = new MIRTypeDecl(new UnitRocType());
+        returnType = new MIRTypeDecl(TypeTable::unitType());
     }
 
     auto block = new MIRBlock("entry", std::move(this->valueStack));
@@ -131,26 +293,25 @@ void ToMIRVisitor::visit(FunctionCallNode *functionCallNode) {
         arguments[size - 1 - i] = this->valueStack.back();
         this->valueStack.pop_back();
     }
-    auto ctx = (RocFunctionCallContext*) functionCallNode->getContextHolder("typeContext");
+    auto ctx = (RocFunctionCallContext*) functionCallNode->getContextHolder(TYPE_CONTEXT);
     auto tc = ctx->targetFunctionCall;
 
     if (functionCallNode->getParent()->isDotExpr()) {
         auto caller = this->valueStack.back();
         this->valueStack.pop_back();
-        this->valueStack.push_back(new MIRFunctionInstanceCall(
-                caller,
-                functionCallNode->getName(),
-                arguments,
-                tc));
+        auto call = new MIRFunctionInstanceCall(caller, functionCallNode->getName(), arguments, tc);
+        call->symbol = functionCallNode->functionSymbol;
+        this->valueStack.push_back(call);
     } else {
-        auto name = functionCallNode->getName();
-        if (name == "ccall") {
+        if (functionCallNode->functionSymbol == roc::symbols::ccallName) {
             auto targetName = arguments.front()->getText();
             auto returnType = functionCallNode->literalExpr->typeVariables.front();
             arguments.erase(arguments.begin());
-            this->valueStack.push_back(new MIRCCall(targetName, arguments, ((RocTypeNodeContext*) returnType->getContextHolder(TYPE_CONTEXT))->getGivenType()->clone()));
+            this->valueStack.push_back(new MIRCCall(targetName, arguments, ((RocTypeNodeContext*) returnType->getContextHolder(TYPE_CONTEXT))->getGivenType()));
         } else {
-            this->valueStack.push_back(new MIRFunctionCall(functionCallNode->getName(), arguments, tc));
+            auto call = new MIRFunctionCall(functionCallNode->getName(), arguments, tc);
+            call->symbol = functionCallNode->functionSymbol;
+            this->valueStack.push_back(call);
         }
     }
 }
@@ -167,7 +328,7 @@ void ToMIRVisitor::visit(IntNode *intNode) {
 }
 
 void ToMIRVisitor::visit(LocalAccess *node) {
-    auto t = ((RocTypeNodeContext*) node->getContextHolder(TYPE_CONTEXT))->getGivenType()->clone();
+    auto t = ((RocTypeNodeContext*) node->getContextHolder(TYPE_CONTEXT))->getGivenType();
     this->valueStack.push_back(new MIRLocalVariableAccess(node->localVariableRef->name,
                                                          node->localVariableRef->index,
                                                          t));
@@ -344,7 +505,7 @@ std::string MIRFunction::getName() {
 }
 
 MIRRawString::MIRRawString(std::string value) : value(std::move(value)) {
-    this->type = new RocRawStringType(value.length());
+    this->type = TypeTable::rawStringType(this->value.length());
 }
 
 void MIRRawString::accept(MIRVisitor *mirVisitor) {
@@ -480,6 +641,7 @@ void SmartTypeCaster::visit(MIRFunctionInstanceCall *node) {
     auto caller = node->caller;
     if (caller->getType()->isPrimitive()) {
         node->caller = new MIRToWrapper(caller);
+        node->caller->parent = node;
     }
     SmartTypeCaster::visit((MIRFunctionCall*) node);
 }
@@ -488,23 +650,22 @@ void SmartTypeCaster::visit(MIRFunctionCall *node) {
     for (const auto &item : node->arguments) item->accept(this);
 
     auto expectedTypes = node->getTargetCall()->getArgumentTypes();
-    int i=0;
-    for (auto& arg: node->arguments) {
-        auto given = arg->getType();
+    for (int i = 0; i < node->arguments.size(); i++) {
+        auto given = node->arguments.at(i)->getType();
         auto expected = expectedTypes.at(i);
-        if (given->equals(expected)) {
+        if (given == expected) {
             continue;
         }
 
         if (given->isPrimitive() && !expected->isPrimitive()) {
-            given = new RocWrapperType(given);
+            given = TypeTable::wrapperType(given);
             auto newValue = new MIRToWrapper(node->arguments.at(i));
             newValue->parent = node;
             node->arguments[i] = newValue;
         }
 
-        if (!given->equals(expected)) {
-            auto newValue = new MIRCastTo(node->arguments.at(i), expected->clone());
+        if (given != expected) {
+            auto newValue = new MIRCastTo(node->arguments.at(i), expected);
             newValue->parent = node;
             node->arguments[i] = newValue;
         }
@@ -520,27 +681,22 @@ void SmartTypeCaster::visit(MIRFunctionCall *node) {
             node->arguments[i] = newValue;
         }
 */
-        i++;
     }
 }
 
 MIRIf::MIRIf(MIRCondition* condition, MIRBlock* block) : condition(condition), block(block) {
-    this->type = new UnitRocType();
-}
-
-MIRIf::~MIRIf() {
-    delete condition;
-    delete block;
-    delete type;
-    delete endLabel;
-    delete elseBlock;
+    this->condition->parent = this;
+    this->block->parent = this;
+    this->type = TypeTable::unitType();
 }
 
 void MIRIf::accept(MIRVisitor *mirVisitor) {
     mirVisitor->visitIf(this);
 }
 
-MIRCondition::MIRCondition(MIRValue *expr) : expr(expr) {}
+MIRCondition::MIRCondition(MIRValue *expr) : expr(expr) {
+    this->expr->parent = this;
+}
 
 void MIRCondition::accept(MIRVisitor *mirVisitor) {
     mirVisitor->visit(this);
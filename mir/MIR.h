@@ -15,6 +15,8 @@ namespace llvm {
     class Value;
 
     class Function;
+
+    class BasicBlock;
 }
 
 class MIRVisitor;
@@ -28,12 +30,22 @@ namespace roc {
     };
 }
 
+/**
+ * Base class of MIR nodes. Nodes created while an arena is active (see Arena::Scope) are owned by it and
+ * destroyed together with the MIRModule, so nodes never delete each other
+ */
 class MIRValue {
 public:
     MIRValue *parent = nullptr;
 
     MIRValue() = default;
 
+    virtual ~MIRValue() = default;
+
+    static void* operator new(size_t size);
+
+    static void operator delete(void* ptr);
+
     virtual void accept(MIRVisitor *mirVisitor);
 
     virtual std::string getText() {
@@ -53,10 +65,46 @@ public:
         return false;
     }
 
+    virtual bool isIf() {
+        return false;
+    }
+
+    /**
+     * @return true for compile time constants (ints and booleans), see getConstantValue()
+     */
+    virtual bool isConstant() {
+        return false;
+    }
+
+    virtual long long getConstantValue() {
+        throw "Not a constant value";
+    }
+
+    /**
+     * @return true if the value is a new object referenced only by its consumer, see TargetFunctionCall::returnsNewObject
+     */
+    virtual bool isNewObject() {
+        return false;
+    }
+
+    /**
+     * @return false if evaluating this node alone (without its children) can be dropped when the result is unused
+     */
+    virtual bool hasSideEffects() {
+        return true;
+    }
+
     virtual std::vector<MIRValue *> getChildren() {
         std::vector<MIRValue *> result;
         return result;
     }
+
+    /**
+     * Replaces given child with a new value, used by passes rewriting MIR in place
+     */
+    virtual void replaceChild(MIRValue *old, MIRValue *with) {
+        throw "Unsupported replaceChild() operation";
+    }
 };
 
 class MIRRawString : public MIRValue {
@@ -72,6 +120,10 @@ public:
         return value;
     }
 
+    bool hasSideEffects() override {
+        return false;
+    }
+
     RocType *getType() override {
         return type;
     }
@@ -85,10 +137,6 @@ public:
         this->rocType = rocType;
     }
 
-    virtual ~MIRTypeDecl() {
-        delete rocType;
-    }
-
     void accept(MIRVisitor *mirVisitor) override;
 
     std::string getText() override {
@@ -107,10 +155,6 @@ public:
         this->type->parent = this;
     }
 
-    virtual ~MIRFunctionParameter() {
-        delete type;
-    }
-
     std::string getText() override {
         return name + " " + type->getText();
     }
@@ -120,12 +164,13 @@ class MIRBlock : public MIRValue {
 public:
     std::string name;
     std::vector<MIRValue *> values;
-    bool blockInitialized = false;
 
     MIRBlock(std::string name, std::vector<MIRValue *> values);
 
     void accept(MIRVisitor *mirVisitor) override;
 
+    void replaceChild(MIRValue *old, MIRValue *with) override;
+
     std::string getText() override {
         std::string acc;
         for (auto &v: values) {
@@ -141,14 +186,12 @@ public:
 
     MIRCondition(MIRValue *expr);
 
-    ~MIRCondition() {
-        delete expr;
-    }
-
     std::vector<MIRValue *> getChildren() override {
         return {expr};
     }
 
+    void replaceChild(MIRValue *old, MIRValue *with) override;
+
     void accept(MIRVisitor *mirVisitor) override;
 
     std::string getText() override {
@@ -166,6 +209,49 @@ public:
     std::string name;
 
     MIRLabel(int id, const std::string &name);
+
+    static void* operator new(size_t size);
+
+    static void operator delete(void* ptr);
+};
+
+/**
+ * Node of the function's control flow graph (see ControlFlowGraphBuilder): straight-line values ending
+ * with a terminator which is either a return value, a conditional branch on condition (successors are
+ * the true and the false target) or a jump to the only successor
+ */
+class MIRBasicBlock : public MIRValue {
+public:
+    int id;
+    std::string name;
+    std::vector<MIRValue *> values;
+    MIRCondition *condition = nullptr;
+    std::vector<MIRBasicBlock *> successors;
+    std::vector<MIRBasicBlock *> predecessors;
+    MIRBasicBlock *immediateDominator = nullptr;
+    int order = -1; //reverse post order index, -1 for unreachable blocks
+    llvm::BasicBlock *llvmBlock = nullptr;
+
+    MIRBasicBlock(int id, std::string name) : id(id), name(std::move(name)) {}
+
+    void accept(MIRVisitor *mirVisitor) override;
+
+    std::vector<MIRValue *> getChildren() override;
+
+    void replaceChild(MIRValue *old, MIRValue *with) override;
+
+    bool isTerminated() {
+        return !successors.empty() || (!values.empty() && values.back()->isReturn());
+    }
+
+    /**
+     * @return true if every path from the entry block to given block goes through this block
+     */
+    bool dominates(MIRBasicBlock *block);
+
+    std::string getText() override {
+        return name + "." + std::to_string(id);
+    }
 };
 
 class MIRIf : public MIRValue {
@@ -180,7 +266,6 @@ public:
 
     MIRIf(MIRCondition *condition, MIRBlock *block);
 
-    ~MIRIf();
 
     std::vector<MIRValue *> getChildren() override {
         return {condition, block};
@@ -188,6 +273,10 @@ public:
 
     void accept(MIRVisitor *mirVisitor) override;
 
+    bool isIf() override {
+        return true;
+    }
+
     std::string getText() override {
         return condition->getText() + block->getText();
     }
@@ -210,11 +299,6 @@ public:
 
     MIRElse(MIRBlock *block, MIRIf *ifBlock) : block(block), ifBlock(ifBlock) {}
 
-    ~MIRElse() {
-        delete block;
-        delete ifBlock;
-    }
-
     void accept(MIRVisitor *mirVisitor) override;
 
     std::vector<MIRValue *> getChildren() override {
@@ -238,7 +322,7 @@ public:
     RocBoolType* type;
 
     explicit MIRTrue() {
-        this->type = new RocBoolType();
+        this->type = TypeTable::boolType();
     }
 
     void accept(MIRVisitor *mirVisitor) override;
@@ -247,6 +331,18 @@ public:
         return "true";
     }
 
+    bool isConstant() override {
+        return true;
+    }
+
+    long long getConstantValue() override {
+        return 1;
+    }
+
+    bool hasSideEffects() override {
+        return false;
+    }
+
     RocType *getType() override {
         return type;
     }
@@ -257,7 +353,7 @@ public:
     RocBoolType* type;
 
     explicit MIRFalse() {
-        this->type = new RocBoolType();
+        this->type = TypeTable::boolType();
     }
 
     void accept(MIRVisitor *mirVisitor) override;
@@ -266,6 +362,18 @@ public:
         return "false";
     }
 
+    bool isConstant() override {
+        return true;
+    }
+
+    long long getConstantValue() override {
+        return 0;
+    }
+
+    bool hasSideEffects() override {
+        return false;
+    }
+
     RocType *getType() override {
         return type;
     }
@@ -278,7 +386,7 @@ public:
 
     explicit MIRConstantInt(int value) {
         this->value = value;
-        this->type = new RocInt32Type();
+        this->type = TypeTable::int32Type();
     }
 
     void accept(MIRVisitor *mirVisitor) override;
@@ -287,6 +395,18 @@ public:
         return std::to_string(value);
     }
 
+    bool isConstant() override {
+        return true;
+    }
+
+    long long getConstantValue() override {
+        return value;
+    }
+
+    bool hasSideEffects() override {
+        return false;
+    }
+
     RocType *getType() override {
         return type;
     }
@@ -310,6 +430,10 @@ public:
         return name;
     }
 
+    bool hasSideEffects() override {
+        return false;
+    }
+
     RocType *getType() override {
         return type;
     }
@@ -323,6 +447,12 @@ public:
 
     void accept(MIRVisitor *mirVisitor) override;
 
+    void replaceChild(MIRValue *old, MIRValue *with) override;
+
+    std::vector<MIRValue *> getChildren() override {
+        return {value};
+    }
+
     std::string getText() override {
         return "ret " + value->getText();
     }
@@ -341,7 +471,7 @@ public:
     RocType* type;
 
     MIRReturnVoidValue() {
-        this->type = new UnitRocType();
+        this->type = TypeTable::unitType();
     }
 
     void accept(MIRVisitor *mirVisitor) override;
@@ -366,6 +496,7 @@ public:
     MIRBlock *body;
     MIRTypeDecl *returnTypeDecl;
     FunctionDeclaration *functionDeclaration;
+    std::vector<MIRBasicBlock *> blocks; //control flow graph of the body, entry block first
 
     llvm::Function *llvmFunction{};
     std::map<int, llvm::Value *> localsMap;
@@ -407,6 +538,7 @@ protected:
     TargetFunctionCall *targetCall{};
 public:
     std::string name{};
+    SymbolId symbol = noSymbol; //interned name from the call site, noSymbol for calls created by passes
     std::vector<MIRValue *> arguments{};
 
     MIRFunctionCall() = default;
@@ -418,18 +550,31 @@ public:
         this->name = std::move(name);
         this->arguments = std::move(arguments);
         this->targetCall = targetCall;
+        for (auto &arg: this->arguments) {
+            arg->parent = this;
+        }
     }
 
     TargetFunctionCall* getTargetCall() {
         return targetCall;
     }
 
+    bool isNewObject() override {
+        return targetCall && targetCall->returnsNewObject();
+    }
+
     virtual std::string getName() {
         return targetCall->getName();
     }
 
     void accept(MIRVisitor *mirVisitor) override;
 
+    std::vector<MIRValue *> getChildren() override {
+        return arguments;
+    }
+
+    void replaceChild(MIRValue *old, MIRValue *with) override;
+
     RocType *getType() override {
         return targetCall->getReturnType();
     }
@@ -481,12 +626,24 @@ public:
                             TargetFunctionCall *targetCall) {
 
         this->caller = caller;
+        this->caller->parent = this;
         this->name = std::move(name);
         this->arguments = std::move(arguments);
         this->targetCall = targetCall;
+        for (auto &arg: this->arguments) {
+            arg->parent = this;
+        }
     }
 
     void accept(MIRVisitor *mirVisitor) override;
+
+    std::vector<MIRValue *> getChildren() override {
+        std::vector<MIRValue *> result = {caller};
+        result.insert(result.end(), arguments.begin(), arguments.end());
+        return result;
+    }
+
+    void replaceChild(MIRValue *old, MIRValue *with) override;
 };
 
 class MIRBinOpBase : public MIRValue {
@@ -503,16 +660,18 @@ public:
         this->right->parent = this;
     }
 
-    ~MIRBinOpBase() {
-        delete type;
-    }
-
     virtual void accept(MIRVisitor *mirVisitor);
 
     std::vector<MIRValue *> getChildren() override {
         return {left, right};
     }
 
+    bool hasSideEffects() override {
+        return false;
+    }
+
+    void replaceChild(MIRValue *old, MIRValue *with) override;
+
     std::string getText() override {
         return left->getText() + symbol + right->getText();
     }
@@ -538,7 +697,7 @@ public:
     MIRInt64Mod(MIRValue *left, MIRValue *right) : MIRBinOpBase(std::move(left),
                                                                 std::move(right),
                                                                 "%") {
-        this->type = new RocInt64Type();
+        this->type = TypeTable::int64Type();
     }
 
     void accept(MIRVisitor *mirVisitor) override;
@@ -549,7 +708,7 @@ public:
     MIRInt32Mod(MIRValue *left, MIRValue *right) : MIRBinOpBase(std::move(left),
                                                                 std::move(right),
                                                                 "%") {
-        this->type = new RocInt32Type();
+        this->type = TypeTable::int32Type();
     }
 
     void accept(MIRVisitor *mirVisitor) override;
@@ -560,7 +719,7 @@ public:
     MIRInt64Add(MIRValue *left, MIRValue *right) : MIRBinOpBase(std::move(left),
                                                                 std::move(right),
                                                                 "+") {
-        this->type = new RocInt64Type();
+        this->type = TypeTable::int64Type();
     }
 
     void accept(MIRVisitor *mirVisitor) override;
@@ -571,7 +730,7 @@ public:
     MIRInt32Add(MIRValue *left, MIRValue *right) : MIRBinOpBase(std::move(left),
                                                                 std::move(right),
                                                                 "+") {
-        this->type = new RocInt32Type();
+        this->type = TypeTable::int32Type();
     }
 
     void accept(MIRVisitor *mirVisitor) override;
@@ -582,7 +741,7 @@ public:
     MIRInt32Sub(MIRValue *left, MIRValue *right) : MIRBinOpBase(std::move(left),
                                                                 std::move(right),
                                                                 "-") {
-        this->type = new RocInt32Type();
+        this->type = TypeTable::int32Type();
     }
 
     void accept(MIRVisitor *mirVisitor) override;
@@ -593,7 +752,7 @@ public:
     MIRInt64Sub(MIRValue *left, MIRValue *right) : MIRBinOpBase(std::move(left),
                                                                 std::move(right),
                                                                 "-") {
-        this->type = new RocInt32Type();
+        this->type = TypeTable::int32Type();
     }
 
     void accept(MIRVisitor *mirVisitor) override;
@@ -604,7 +763,7 @@ public:
     MIRInt32Div(MIRValue *left, MIRValue *right) : MIRBinOpBase(std::move(left),
                                                                 std::move(right),
                                                                 "/") {
-        this->type = new RocFloat64Type();
+        this->type = TypeTable::float64Type();
     }
 
     void accept(MIRVisitor *mirVisitor) override;
@@ -615,7 +774,7 @@ public:
     MIRInt64Div(MIRValue *left, MIRValue *right) : MIRBinOpBase(std::move(left),
                                                                 std::move(right),
                                                                 "/") {
-        this->type = new RocFloat64Type();
+        this->type = TypeTable::float64Type();
     }
 
     void accept(MIRVisitor *mirVisitor) override;
@@ -626,7 +785,7 @@ public:
     MIRInt32Mul(MIRValue *left, MIRValue *right) : MIRBinOpBase(std::move(left),
                                                                 std::move(right),
                                                                 "*") {
-        this->type = new RocInt32Type();
+        this->type = TypeTable::int32Type();
     }
 
     void accept(MIRVisitor *mirVisitor) override;
@@ -637,7 +796,7 @@ public:
     MIRInt64Mul(MIRValue *left, MIRValue *right) : MIRBinOpBase(std::move(left),
                                                                 std::move(right),
                                                                 "*") {
-        this->type = new RocInt64Type();
+        this->type = TypeTable::int64Type();
     }
 
     void accept(MIRVisitor *mirVisitor) override;
@@ -651,7 +810,7 @@ class MIRAnd : public MIRBinOpBase {
 public:
     MIRAnd(MIRValue *left,
            MIRValue *right) : MIRBinOpBase(std::move(left), std::move(right), "and") {
-        this->type = new RocBoolType();
+        this->type = TypeTable::boolType();
     }
 
     void accept(MIRVisitor *mirVisitor) override;
@@ -661,7 +820,7 @@ class MIROr : public MIRBinOpBase {
 public:
     MIROr(MIRValue *left,
           MIRValue *right) : MIRBinOpBase(std::move(left), std::move(right), "or") {
-        this->type = new RocBoolType();
+        this->type = TypeTable::boolType();
     }
 
     void accept(MIRVisitor *mirVisitor) override;
@@ -671,7 +830,7 @@ class MIRInt32Eq : public MIRBinOpBase {
 public:
     MIRInt32Eq(MIRValue *left,
                MIRValue *right) : MIRBinOpBase(std::move(left), std::move(right), "==") {
-        this->type = new RocBoolType();
+        this->type = TypeTable::boolType();
     }
 
     void accept(MIRVisitor *mirVisitor) override;
@@ -680,7 +839,7 @@ public:
 class MIRInt32NotEq : public MIRBinOpBase {
 public:
     MIRInt32NotEq(MIRValue *left, MIRValue *right) : MIRBinOpBase(std::move(left), std::move(right), "!=") {
-        this->type = new RocBoolType();
+        this->type = TypeTable::boolType();
     }
 
     void accept(MIRVisitor *mirVisitor) override;
@@ -690,7 +849,7 @@ class MIRInt32Gt : public MIRBinOpBase {
 public:
     MIRInt32Gt(MIRValue *left,
                MIRValue *right) : MIRBinOpBase(std::move(left), std::move(right), ">") {
-        this->type = new RocBoolType();
+        this->type = TypeTable::boolType();
     }
 
     void accept(MIRVisitor *mirVisitor) override;
@@ -700,7 +859,7 @@ class MIRInt32Lt : public MIRBinOpBase {
 public:
     MIRInt32Lt(MIRValue *left,
                MIRValue *right) : MIRBinOpBase(std::move(left), std::move(right), "<") {
-        this->type = new RocBoolType();
+        this->type = TypeTable::boolType();
     }
 
     void accept(MIRVisitor *mirVisitor) override;
@@ -710,7 +869,7 @@ class MIRInt32Le : public MIRBinOpBase {
 public:
     MIRInt32Le(MIRValue *left,
                MIRValue *right) : MIRBinOpBase(std::move(left), std::move(right), "<=") {
-        this->type = new RocBoolType();
+        this->type = TypeTable::boolType();
     }
 
     void accept(MIRVisitor *mirVisitor) override;
@@ -720,7 +879,7 @@ class MIRInt32Ge : public MIRBinOpBase {
 public:
     MIRInt32Ge(MIRValue *left,
                MIRValue *right) : MIRBinOpBase(std::move(left), std::move(right), ">=") {
-        this->type = new RocBoolType();
+        this->type = TypeTable::boolType();
     }
 
     void accept(MIRVisitor *mirVisitor) override;
@@ -734,11 +893,15 @@ public:
     explicit MIRStringToRaw(MIRValue *expr) {
         this->expr = std::move(expr);
         this->expr->parent = this;
-        this->type = new RocRawStringType(-1);
+        this->type = TypeTable::rawStringType(-1);
     }
 
     void accept(MIRVisitor *mirVisitor) override;
 
+    std::vector<MIRValue *> getChildren() override {
+        return {expr};
+    }
+
     RocType *getType() override {
         return type;
     }
@@ -752,11 +915,17 @@ public:
     explicit MIRToPtr(MIRValue *expr) {
         this->expr = expr;
         this->expr->parent = this;
-        this->type = new RocPtrType(expr->getGenericType()->clone());
+        this->type = TypeTable::ptrType(expr->getGenericType());
     }
 
     void accept(MIRVisitor *mirVisitor) override;
 
+    std::vector<MIRValue *> getChildren() override {
+        return {expr};
+    }
+
+    void replaceChild(MIRValue *old, MIRValue *with) override;
+
     RocType *getType() override {
         return type;
     }
@@ -770,11 +939,17 @@ public:
     explicit MIRToWrapper(MIRValue *expr) {
         this->expr = expr;
         this->expr->parent = this;
-        this->type = new RocWrapperType(expr->getGenericType()->clone());
+        this->type = TypeTable::wrapperType(expr->getGenericType());
     }
 
     void accept(MIRVisitor *mirVisitor) override;
 
+    std::vector<MIRValue *> getChildren() override {
+        return {expr};
+    }
+
+    void replaceChild(MIRValue *old, MIRValue *with) override;
+
     RocType *getType() override {
         return type;
     }
@@ -793,20 +968,30 @@ public:
 
     void accept(MIRVisitor *mirVisitor) override;
 
+    std::vector<MIRValue *> getChildren() override {
+        return {from};
+    }
+
+    void replaceChild(MIRValue *old, MIRValue *with) override;
+
     RocType *getType() override {
         return targetType;
     }
+
+    bool isNewObject() override {
+        return from->isNewObject();
+    }
 };
 
 class MIRInt32Array : public MIRValue {
 public:
-    std::unique_ptr<RocArrayType> at;
+    RocArrayType* at;
     std::vector<MIRValue *> elements;
     roc::AllocationSpace allocationSpace = roc::AllocationSpace::StackAllocation;
 
     explicit MIRInt32Array(std::vector<MIRValue *> elements) {
         this->elements = std::move(elements);
-        this->at = std::make_unique<RocArrayType>(new RocInt32Type());
+        this->at = TypeTable::arrayType(TypeTable::int32Type());
         for (auto &e: this->elements) {
             e->parent = this;
         }
@@ -814,8 +999,14 @@ public:
 
     void accept(MIRVisitor *mirVisitor) override;
 
+    std::vector<MIRValue *> getChildren() override {
+        return elements;
+    }
+
+    void replaceChild(MIRValue *old, MIRValue *with) override;
+
     RocType *getType() override {
-        return at.get();
+        return at;
     }
 };
 
@@ -840,6 +1031,10 @@ public:
 
     void accept(MIRVisitor *mirVisitor) override;
 
+    std::vector<MIRValue *> getChildren() override {
+        return {ref, index, value};
+    }
+
     RocType *getType() override {
         return type.get();
     }
@@ -861,6 +1056,10 @@ public:
 
     void accept(MIRVisitor *mirVisitor) override;
 
+    std::vector<MIRValue *> getChildren() override {
+        return {ref, index};
+    }
+
     RocType *getType() override {
         return type.get();
     }
@@ -868,6 +1067,7 @@ public:
 
 class MIRModule {
 public:
+    std::unique_ptr<Arena> arena; //owns all MIR of the module, released after the functions
     std::string name;
     std::vector<std::unique_ptr<MIRFunction>> functions;
     std::shared_ptr<ModuleDeclaration> moduleDeclaration;
@@ -979,12 +1179,31 @@ public:
     };
 
     virtual void visit(MIRFunction *mirFunction) {
+        if (!mirFunction->blocks.empty()) {
+            for (auto &block: mirFunction->blocks) {
+                block->accept(this);
+            }
+            return;
+        }
         for (auto &expr: mirFunction->body->values) {
             expr->accept(this);
         }
     };
 
-    virtual void visit(MIRBlock *mirBlock) {};
+    virtual void visit(MIRBlock *mirBlock) {
+        for (auto &value: mirBlock->values) {
+            value->accept(this);
+        }
+    };
+
+    virtual void visit(MIRBasicBlock *mirBasicBlock) {
+        for (auto &value: mirBasicBlock->values) {
+            value->accept(this);
+        }
+        if (mirBasicBlock->condition) {
+            mirBasicBlock->condition->accept(this);
+        }
+    };
 
     virtual void visit(MIRFunctionParameter *mirFunctionParameter) {};
 
@@ -4,6 +4,28 @@
 #include "AST.h"
 #include "Parser.h"
 
+/**
+ * Every node is prefixed with the arena it was allocated from (nullptr for heap)
+ */
+static constexpr size_t nodeHeaderSize = alignof(std::max_align_t);
+
+void* ASTNode::operator new(size_t size) {
+    auto arena = Arena::active;
+    auto header = (Arena**) (arena ? arena->allocate(size + nodeHeaderSize) : ::operator new(size + nodeHeaderSize));
+    *header = arena;
+    return (char*) header + nodeHeaderSize;
+}
+
+void ASTNode::operator delete(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    auto header = (Arena**) ((char*) ptr - nodeHeaderSize);
+    if (*header == nullptr) {
+        ::operator delete(header);
+    }
+}
+
 static void reportSytnaxError(Token *token, Lexer *lexer) {
     throw SyntaxException(("Expected '}' got '" + token->getText() + "'").c_str(), token, lexer->filePath);
 }
@@ -398,7 +420,7 @@ FunctionDeclaration *FunctionVisitor::visit(VisitingContext *ctx) const {
                               next,
                               lexer->filePath);
     } else {
-        functionReturnTypeNode = new FunctionVoidReturnTypeNode();
+        functionReturnTypeNode = new FunctionVoidReturnTypeNode(*lexer->arena);
     }
 
 
@@ -434,8 +456,8 @@ FunctionDeclaration::FunctionDeclaration(FunKeyword *keyword,
     this->parameterList = std::move(parameterList);
     this->functionReturnTypeNode = std::move(functionReturnTypeNode);
     this->body = std::move(body);
-    this->parameterList->nodeContext->parent = this;
-    this->body->nodeContext->parent = this;
+    this->parameterList->nodeContext.parent = this;
+    this->body->nodeContext.parent = this;
     this->leftCurl = leftCurl;
     this->rightCurl = rightCurl;
 }
@@ -756,6 +778,7 @@ FunctionCallNode::FunctionCallNode(std::unique_ptr<LiteralExpr> literalExpr,
     this->argumentList->setParent(this);
     this->literalExpr->setParent(this);
     this->functionName = this->literalExpr->literal->getText();
+    this->functionSymbol = this->literalExpr->literal->symbol;
 }
 
 void FunctionCallNode::accept(ASTVisitor *visitor) {
@@ -1136,6 +1159,9 @@ void StringVisitor::visit(QuotionMark *lqm, VisitingContext *ctx) {
     std::vector<Token *> tokens;
     Token *rqm = nullptr;
 
+    if (auto body = lexer->nextStringBody()) {
+        tokens.push_back(body);
+    }
     while (lexer->hasNext()) {
         auto current = lexer->nextTokenWithWS();
         if (current->getTokenType() == ElementType::quotationMark) {
@@ -1241,7 +1267,7 @@ ArrayCreateExpr::ArrayCreateExpr(std::unique_ptr<Token> lb,
     this->rb = std::move(rb);
     this->arguments = std::move(arguments);
     for (const auto &a: this->arguments) {
-        a->nodeContext->parent = this;
+        a->nodeContext.parent = this;
     }
 }
 
@@ -1516,7 +1542,8 @@ void IfVisitor::visit(IfKeyword *ifKeyword, VisitingContext *ctx) {
     this->conditionalExpression = ifExpression;
 }
 
-FunctionVoidReturnTypeNode::FunctionVoidReturnTypeNode() : FunctionReturnTypeNode(new SingleTypeNode(new Literal(0, "Unit"))) {}
+FunctionVoidReturnTypeNode::FunctionVoidReturnTypeNode(Arena& arena) :
+        FunctionReturnTypeNode(new SingleTypeNode(new (arena) Literal(0, "Unit", roc::symbols::unitName))) {}
 
 void FunctionVoidReturnTypeNode::accept(ASTVisitor *visitor) {
     visitor->visit(this);
@@ -1539,8 +1566,8 @@ BinExpr::BinExpr(std::unique_ptr<Expression> left,
     this->left = std::move(left);
     this->op = std::move(op);
     this->right = std::move(right);
-    this->right->nodeContext->parent = this;
+    this->right->nodeContext.parent = this;
     if (this->left) {
-        this->left->nodeContext->parent = this;
+        this->left->nodeContext.parent = this;
     }
 }
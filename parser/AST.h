@@ -9,6 +9,7 @@
 
 #include <list>
 #include <map>
+#include <unordered_map>
 #include <set>
 #include <utility>
 #include <vector>
@@ -46,6 +47,8 @@ class FunctionCallNode;
 
 class Lexer;
 
+class SourceBuffer;
+
 class Expression;
 
 class LocalVariableRef;
@@ -56,13 +59,22 @@ class NodeContextHolder {
 
 };
 
+/**
+ * Slots of contexts attached to AST nodes by compilation phases
+ */
+enum NodeContextSlot {
+    typeContextSlot, //RocTypeNodeContext, RocFunctionCallContext for calls, RocFunctionContext for functions
+
+    contextSlotsCount
+};
+
 /**
  * Base class for compilation unit i.e. function, static block, module
  */
 class CompilationNode {
 public:
-    std::set<std::string> globalSymbols;
-    std::map<std::string, LocalVariableRef*> localSymbols;
+    std::set<SymbolId> globalSymbols;
+    std::unordered_map<SymbolId, LocalVariableRef*> localSymbols;
     std::vector<std::unique_ptr<LocalVariableRef>> locals;
 
     CompilationNode();
@@ -104,40 +116,48 @@ public:
  */
 class ASTNode {
 private:
-    std::map<std::string, NodeContextHolder*> contextHolder{};
+    NodeContextHolder* contextHolders[contextSlotsCount]{};
 public:
-    std::unique_ptr<NodeContext> nodeContext;
+    NodeContext nodeContext;
 
-    explicit ASTNode(ElementType elementType) {
-        this->nodeContext = std::make_unique<NodeContext>(elementType);
+    explicit ASTNode(ElementType elementType) : nodeContext(elementType) {
     }
 
     virtual ~ASTNode() = default;
 
-    NodeContextHolder* addContextHolder(const std::string& key, NodeContextHolder* givenContext) {
-        contextHolder.insert({key, givenContext});
-        return getContextHolder(key);
+    /**
+     * Nodes created while an arena is active (see Arena::Scope) are placed in it, the others on the heap
+     */
+    static void* operator new(size_t size);
+
+    static void operator delete(void* ptr);
+
+    /**
+     * Attaches given context if the slot is free
+     *
+     * @return context held in given slot
+     */
+    NodeContextHolder* addContextHolder(NodeContextSlot slot, NodeContextHolder* givenContext) {
+        if (!contextHolders[slot]) {
+            contextHolders[slot] = givenContext;
+        }
+        return contextHolders[slot];
     }
 
-    bool containsContext(const std::string& key) {
-        auto it = contextHolder.find(key);
-        if (it != contextHolder.end()) {
-            return true;
-        } else {
-            return false;
-        }
+    bool containsContext(NodeContextSlot slot) const {
+        return contextHolders[slot] != nullptr;
     }
 
-    NodeContextHolder* getContextHolder(const std::string& key) {
-        return contextHolder.find(key)->second;
+    NodeContextHolder* getContextHolder(NodeContextSlot slot) const {
+        return contextHolders[slot];
     }
 
-    void setParent(ASTNode *parent) const {
-        this->nodeContext->parent = parent;
+    void setParent(ASTNode *parent) {
+        this->nodeContext.parent = parent;
     }
 
     virtual ElementType getNodeType() {
-        return nodeContext->nodeType;
+        return nodeContext.nodeType;
     };
 
     virtual void accept(ASTVisitor *) = 0;
@@ -153,7 +173,7 @@ public:
     virtual std::string getText() = 0;
 
     virtual ASTNode *getParent() {
-        return this->nodeContext->parent;
+        return this->nodeContext.parent;
     }
 
     virtual bool isLiteralExpr() {
@@ -481,7 +501,7 @@ public:
                           std::unique_ptr<Token> rb) : Expression(ElementType::arrayAnonymousGetExpr) {
         this->lb = std::move(lb);
         this->index = std::move(index);
-        this->index->nodeContext->parent = this;
+        this->index->nodeContext.parent = this;
         this->rb = std::move(rb);
     }
 
@@ -505,7 +525,7 @@ public:
                  std::unique_ptr<Token> rb) : Expression(ElementType::arrayGetExpr) {
         this->lb = std::move(lb);
         this->index = std::move(index);
-        this->index->nodeContext->parent = this;
+        this->index->nodeContext.parent = this;
         this->rb = std::move(rb);
     }
 
@@ -1013,7 +1033,7 @@ public:
 
 class FunctionVoidReturnTypeNode : public FunctionReturnTypeNode {
 public:
-    FunctionVoidReturnTypeNode();
+    explicit FunctionVoidReturnTypeNode(Arena& arena);
 
     void accept(ASTVisitor *) override;
 
@@ -1114,6 +1134,7 @@ public:
     std::unique_ptr<LiteralExpr> literalExpr;
     std::unique_ptr<ArgumentList> argumentList;
     std::string functionName;
+    SymbolId functionSymbol;
 
     FunctionCallNode(std::unique_ptr<LiteralExpr> literalExpr, std::unique_ptr<ArgumentList> argumentList);
 
@@ -1357,7 +1378,22 @@ public:
     std::vector<std::unique_ptr<ImportDeclaration>> imports;
 };
 
-class ModuleDeclaration : public ASTNode, public CompilationNode, public WithFields, public WithImports {
+/**
+ * Source, arena and interner a module's tree is built from. Tokens view the source and nodes live in the arena,
+ * as the first base of ModuleDeclaration it is destroyed after every other base and member of the module
+ */
+class ModuleStorage {
+public:
+    std::shared_ptr<SourceBuffer> sourceBuffer;
+    std::shared_ptr<Arena> arena;
+    std::shared_ptr<Interner> interner; //symbols of the module's identifiers
+};
+
+class ModuleDeclaration : public ModuleStorage,
+                          public ASTNode,
+                          public CompilationNode,
+                          public WithFields,
+                          public WithImports {
 public:
     std::string moduleName;
     std::string absolutePath;
@@ -1630,10 +1666,47 @@ public:
     FunctionDeclaration *visit(VisitingContext *ctx) const;
 };
 
+/**
+ * What the backend produces, every mode generates machine code at most once
+ */
+enum RocOutputMode {
+    emitAsm, //assembly file
+    emitObj, //object file
+    emitIR, //textual LLVM IR
+    jitRun //in memory code, see RocCompilationResult::EE
+};
+
 class Config {
 public:
     std::string srcInput;
-    std::string srcOutput;
+    std::string srcOutput; //path of emitted file, output.s, output.o or output.ll by default
+    RocOutputMode outputMode = jitRun; //--emit
+    int optimizationLevel = 0; //0-3, same meaning as -O0 ... -O3
+    std::string targetCpu = "generic"; //--mcpu, "native" for the host CPU
+    std::string targetFeatures; //--mattr i.e. +avx2,-avx512f or "native" for the host features
+    std::string mirPasses = "devirt,constprop,dce"; //--mir-passes, optimization passes run on MIR in given order
+    bool verifyMIR = false; //--verify-mir, checks MIR after every pass
+    bool timeMIRPasses = false; //--time-mir-passes, prints time and allocations of every MIR pass
+    bool timeReport = false; //--time-report, prints wall time, CPU time and peak RSS growth of compiler phases
+    std::string timeReportJSON; //--time-report=<path>, writes the same report as JSON to given file
+    std::string traceFile; //--trace=<path>, writes Chrome trace events of the compilation to given file
+    int int32CacheMin = -128; //--int32-cache=<min>,<max>, range of preallocated boxed Int32 values,
+    int int32CacheMax = 1023; //empty if min > max, not used if wider than int32CacheLimit
+    static constexpr long long int32CacheLimit = 65536; //most values in the boxed Int32 table
+
+    std::string getOutputPath() const {
+        if (!srcOutput.empty()) {
+            return srcOutput;
+        }
+        switch (outputMode) {
+            case emitObj:
+                return "output.o";
+            case emitIR:
+                return "output.ll";
+            default:
+                return "output.s";
+        }
+    }
 };
 
 class ASTVisitor {
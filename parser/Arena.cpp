@@ -0,0 +1,21 @@
+#include "Arena.h"
+
+thread_local Arena* Arena::active = nullptr;
+
+Arena::~Arena() {
+    for (auto it = finalizers.rbegin(); it != finalizers.rend(); it++) {
+        it->second(it->first);
+    }
+}
+
+void* Arena::allocateBlock(size_t size) {
+    if (size > blockSize / 4) {
+        //oversized request gets its own block, current block stays in use
+        blocks.emplace_back(new char[size]);
+        return blocks.back().get();
+    }
+    blocks.emplace_back(new char[blockSize]);
+    current = blocks.back().get() + size;
+    remaining = blockSize - size;
+    return blocks.back().get();
+}
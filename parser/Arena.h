@@ -0,0 +1,97 @@
+#pragma once
+#ifndef ROC_LANG_ARENA_H
+#define ROC_LANG_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * Bump allocator for tokens, AST and MIR nodes of a single compilation. Memory is released all at once when
+ * the arena is destroyed, deleting a single token or node only runs its destructor.
+ */
+class Arena {
+private:
+    static constexpr size_t blockSize = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> blocks;
+    std::vector<std::pair<void*, void (*)(void*)>> finalizers;
+    char* current = nullptr;
+    size_t remaining = 0;
+    size_t allocations = 0;
+    size_t allocatedBytes = 0;
+
+    void* allocateBlock(size_t size);
+
+public:
+    /**
+     * Arena used for AST nodes created on the current thread, nullptr if nodes go to the heap
+     */
+    static thread_local Arena* active;
+
+    /**
+     * Makes given arena active for the lifetime of the scope
+     */
+    class Scope {
+    private:
+        Arena* previous;
+    public:
+        explicit Scope(Arena* arena) : previous(active) {
+            active = arena;
+        }
+
+        ~Scope() {
+            active = previous;
+        }
+
+        Scope(const Scope&) = delete;
+
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    Arena() = default;
+
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t size) {
+        size = (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+        allocations++;
+        allocatedBytes += size;
+        if (size > remaining) {
+            return allocateBlock(size);
+        }
+        auto result = current;
+        current += size;
+        remaining -= size;
+        return result;
+    }
+
+    /**
+     * Registers function called with given object when the arena is destroyed, in reverse order of registration
+     */
+    void addFinalizer(void* object, void (*finalizer)(void*)) {
+        finalizers.emplace_back(object, finalizer);
+    }
+
+    size_t allocatedBlocks() const {
+        return blocks.size();
+    }
+
+    /**
+     * @return number of allocate() calls so far, used to attribute allocations to compiler passes
+     */
+    size_t allocationCount() const {
+        return allocations;
+    }
+
+    size_t allocatedSize() const {
+        return allocatedBytes;
+    }
+};
+
+#endif //ROC_LANG_ARENA_H
@@ -0,0 +1,201 @@
+#pragma once
+#ifndef ROC_LANG_CHARSCAN_H
+#define ROC_LANG_CHARSCAN_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "llvm/Support/MathExtras.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ROC_SCAN_SSE2
+#endif
+
+/**
+ * Helpers for the lexer to skip runs of characters of the same class 16 (SSE2) or 32 (AVX2) bytes at a time,
+ * with a scalar loop for the tail and for targets without SIMD
+ */
+namespace charscan {
+
+    /**
+     * @return true for characters the lexer accumulates into identifiers and numbers,
+     * i.e. everything which does not end a lexeme
+     */
+    constexpr bool isWordCharSlow(unsigned char ch) {
+        switch (ch) {
+            case 0:
+            case 0xFF:
+            case ' ':
+            case '\n':
+            case '!':
+            case '<':
+            case '>':
+            case '-':
+            case '.':
+            case ';':
+            case '{':
+            case '}':
+            case '=':
+            case '(':
+            case ')':
+            case '[':
+            case ']':
+            case ',':
+            case ':':
+            case '"':
+            case '/':
+            case '\\':
+            case '*':
+            case '%':
+            case '^':
+            case '+':
+                return false;
+            default:
+                return true;
+        }
+    }
+
+    constexpr std::array<bool, 256> makeWordCharTable() {
+        std::array<bool, 256> table{};
+        for (int i = 0; i < 256; i++) {
+            table[i] = isWordCharSlow((unsigned char) i);
+        }
+        return table;
+    }
+
+    constexpr std::array<bool, 256> wordCharTable = makeWordCharTable();
+
+    inline bool isWordChar(char ch) {
+        return wordCharTable[(unsigned char) ch];
+    }
+
+    inline bool isAlnum(char ch) {
+        return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') || ch == '_';
+    }
+
+    /**
+     * @return length of the [A-Za-z0-9_] prefix of given range
+     */
+    inline size_t alnumRun(const char* p, size_t n) {
+        size_t i = 0;
+#if defined(__AVX2__)
+        for (; i + 32 <= n; i += 32) {
+            __m256i x = _mm256_loadu_si256((const __m256i*) (p + i));
+            __m256i lower = _mm256_or_si256(x, _mm256_set1_epi8(0x20));
+            __m256i letter = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                                              _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lower));
+            __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(x, _mm256_set1_epi8('0' - 1)),
+                                             _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), x));
+            __m256i underscore = _mm256_cmpeq_epi8(x, _mm256_set1_epi8('_'));
+            auto mask = (uint32_t) _mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(letter, digit), underscore));
+            if (mask != 0xFFFFFFFFu) {
+                return i + llvm::countTrailingZeros(~mask);
+            }
+        }
+#endif
+#if defined(ROC_SCAN_SSE2)
+        for (; i + 16 <= n; i += 16) {
+            __m128i x = _mm_loadu_si128((const __m128i*) (p + i));
+            __m128i lower = _mm_or_si128(x, _mm_set1_epi8(0x20));
+            __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                           _mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), lower));
+            __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8('0' - 1)),
+                                          _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), x));
+            __m128i underscore = _mm_cmpeq_epi8(x, _mm_set1_epi8('_'));
+            auto mask = (uint32_t) _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(letter, digit), underscore));
+            if (mask != 0xFFFFu) {
+                return i + llvm::countTrailingZeros(~mask);
+            }
+        }
+#endif
+        while (i < n && isAlnum(p[i])) {
+            i++;
+        }
+        return i;
+    }
+
+    /**
+     * @return length of the identifier/number prefix of given range
+     */
+    inline size_t wordRun(const char* p, size_t n) {
+        size_t i = 0;
+        while (true) {
+            i += alnumRun(p + i, n - i);
+            if (i == n || !isWordChar(p[i])) {
+                return i;
+            }
+            i++; //rare word characters like '\t' or '?'
+        }
+    }
+
+    /**
+     * @return length of the ' ' prefix of given range
+     */
+    inline size_t spaceRun(const char* p, size_t n) {
+        size_t i = 0;
+#if defined(__AVX2__)
+        for (; i + 32 <= n; i += 32) {
+            __m256i x = _mm256_loadu_si256((const __m256i*) (p + i));
+            auto mask = (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, _mm256_set1_epi8(' ')));
+            if (mask != 0xFFFFFFFFu) {
+                return i + llvm::countTrailingZeros(~mask);
+            }
+        }
+#endif
+#if defined(ROC_SCAN_SSE2)
+        for (; i + 16 <= n; i += 16) {
+            __m128i x = _mm_loadu_si128((const __m128i*) (p + i));
+            auto mask = (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_set1_epi8(' ')));
+            if (mask != 0xFFFFu) {
+                return i + llvm::countTrailingZeros(~mask);
+            }
+        }
+#endif
+        while (i < n && p[i] == ' ') {
+            i++;
+        }
+        return i;
+    }
+
+    /**
+     * @return length of the string literal body prefix of given range, stops at '"' and at characters
+     * the lexer treats specially (0 and end of file marker)
+     */
+    inline size_t stringBodyRun(const char* p, size_t n) {
+        size_t i = 0;
+#if defined(__AVX2__)
+        for (; i + 32 <= n; i += 32) {
+            __m256i x = _mm256_loadu_si256((const __m256i*) (p + i));
+            __m256i stop = _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('"')),
+                                           _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_setzero_si256()),
+                                                           _mm256_cmpeq_epi8(x, _mm256_set1_epi8((char) 0xFF))));
+            auto mask = (uint32_t) _mm256_movemask_epi8(stop);
+            if (mask != 0) {
+                return i + llvm::countTrailingZeros(mask);
+            }
+        }
+#endif
+#if defined(ROC_SCAN_SSE2)
+        for (; i + 16 <= n; i += 16) {
+            __m128i x = _mm_loadu_si128((const __m128i*) (p + i));
+            __m128i stop = _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('"')),
+                                        _mm_or_si128(_mm_cmpeq_epi8(x, _mm_setzero_si128()),
+                                                     _mm_cmpeq_epi8(x, _mm_set1_epi8((char) 0xFF))));
+            auto mask = (uint32_t) _mm_movemask_epi8(stop);
+            if (mask != 0) {
+                return i + llvm::countTrailingZeros(mask);
+            }
+        }
+#endif
+        while (i < n && p[i] != '"' && p[i] != 0 && p[i] != (char) 0xFF) {
+            i++;
+        }
+        return i;
+    }
+}
+
+#endif //ROC_LANG_CHARSCAN_H
@@ -0,0 +1,25 @@
+#include "Interner.h"
+
+Interner::Interner() {
+    //order must match roc::symbols::WellKnownSymbol
+    for (auto name: {"main", "println", "ccall", "toString", "Int32", "Int", "Int64", "Float64", "Bool", "Any",
+                     "String", "Unit", "flush"}) {
+        intern(name);
+    }
+}
+
+SymbolId Interner::intern(std::string_view name) {
+    auto it = ids.find(name);
+    if (it != ids.end()) {
+        return it->second;
+    }
+    auto id = (SymbolId) names.size();
+    names.emplace_back(name);
+    ids.insert({names.back(), id});
+    return id;
+}
+
+SymbolId Interner::find(std::string_view name) const {
+    auto it = ids.find(name);
+    return it == ids.end() ? noSymbol : it->second;
+}
@@ -0,0 +1,73 @@
+#pragma once
+#ifndef ROC_LANG_INTERNER_H
+#define ROC_LANG_INTERNER_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * Compact id of an interned identifier, equal names have equal ids within one compilation
+ */
+using SymbolId = uint32_t;
+
+static const SymbolId noSymbol = UINT32_MAX;
+
+namespace roc::symbols {
+    /**
+     * Names interned up front by every Interner, so passes can compare against them without a lookup
+     */
+    enum WellKnownSymbol : SymbolId {
+        mainName,
+        printlnName,
+        ccallName,
+        toStringName,
+        int32Name,
+        intName,
+        int64Name,
+        float64Name,
+        boolName,
+        anyName,
+        stringName,
+        unitName,
+        flushName,
+
+        wellKnownCount
+    };
+}
+
+/**
+ * Per-compilation identifier table, the lexer resolves every identifier to a SymbolId once and later
+ * phases compare and hash the ids instead of strings
+ */
+class Interner {
+private:
+    std::deque<std::string> names; //deque keeps the strings viewed by ids in place
+    std::unordered_map<std::string_view, SymbolId> ids;
+
+public:
+    Interner();
+
+    Interner(const Interner&) = delete;
+
+    Interner& operator=(const Interner&) = delete;
+
+    SymbolId intern(std::string_view name);
+
+    /**
+     * @return id of the name or noSymbol if it was never interned
+     */
+    SymbolId find(std::string_view name) const;
+
+    std::string_view getName(SymbolId id) const {
+        return names[id];
+    }
+
+    size_t size() const {
+        return names.size();
+    }
+};
+
+#endif //ROC_LANG_INTERNER_H
@@ -2,11 +2,11 @@
 // Created by Marcin Bukowiecki on 2019-09-19.
 //
 #include "Lexer.h"
+#include "CharScan.h"
 #include <string>
 #include <utility>
-#include <fstream>
 
-inline Literal* isNumber(int offset, const std::string& text);
+inline Literal* isNumber(Arena& arena, int offset, std::string_view text);
 
 inline void checkContent(Lexer* lexer) {
     if (lexer->content.empty()) {
@@ -16,28 +16,16 @@ inline void checkContent(Lexer* lexer) {
     }
 }
 
-Lexer::Lexer(const std::string& filePath) {
-    std::string line;
-    std::ifstream scorchFile(filePath);
-    std::string acc;
-
-    if (scorchFile.is_open())
-    {
-        while (getline(scorchFile, line))
-        {
-            if (!acc.empty()) acc+='\n';
-            acc+=line;
-        }
-        scorchFile.close();
-    }
+Lexer::Lexer(const std::string& filePath) : Lexer(SourceBuffer::fromFile(filePath), filePath) {
+}
 
-    this->content = acc;
-    this->filePath = filePath;
-    checkContent(this);
+Lexer::Lexer(std::string content, std::string filePath) : Lexer(SourceBuffer::fromString(std::move(content)),
+                                                                std::move(filePath)) {
 }
 
-Lexer::Lexer(std::string content, std::string filePath) {
-    this->content = std::move(content);
+Lexer::Lexer(std::shared_ptr<SourceBuffer> buffer, std::string filePath) {
+    this->buffer = buffer ? std::move(buffer) : SourceBuffer::fromString("");
+    this->content = this->buffer->getText();
     this->filePath = std::move(filePath);
     checkContent(this);
 }
@@ -48,99 +36,153 @@ char Lexer::nextChar() {
         return -1;
     }
 	this->offset++;
-	char ch = this->content.at(++this->pos);
+	char ch = this->content[++this->pos];
 	this->current = ch;
 	return ch;
 }
 
-static Token* resolveToken(int offset, const std::string& acc, bool isDigit) {
-	if (acc == "fun") {
-		return new FunKeyword(offset);
-
-	} else if (acc == "for") {
-        return new ForKeyword(offset);
-
-    } else if (acc == "met") {
-        return new MetKeyword(offset);
-
-    } else if (acc == "while") {
-        return new WhileKeyword(offset);
-
-    } else if (acc == "ret") {
-		return new RetKeyword(offset);
-
-    } else if (acc == "var") {
-        return new VarKeyword(offset);
-
-    } else if (acc == "val") {
-        return new ValKeyword(offset);
-
-    } else if (acc == "in") {
-        return new InKeyword(offset);
-
-    } else if (acc == "is") {
-        return new IsKeyword(offset);
-
-    } else if (acc == "break") {
-        return new BreakKeyword(offset);
-
-    } else if (acc == "continue") {
-        return new ContinueKeyword(offset);
-
-	} else if (acc == "if") {
-        return new IfKeyword(offset);
-
-    } else if (acc == "else") {
-        return new ElseKeyword(offset);
-
-	} else if (acc == "lam") {
-        return new LamKeyword(offset);
-
-    } else if (acc == "or") {
-        return new OrKeyword(offset);
-
-    } else if (acc == "and") {
-        return new AndKeyword(offset);
-
-    } else if (acc == "import") {
-        return new ImportKeyword(offset);
-
-    } else if (acc == "true") {
-        return new TrueKeyword(offset);
-
-    } else if (acc == "false") {
-        return new FalseKeyword(offset);
-
-    } else if (acc == "struct") {
-        return new StructKeyword(offset);
-
-    } else if (acc == "trait") {
-        return new TraitKeyword(offset);
+void Lexer::skipChars(size_t n) {
+    size_t target = this->pos + n;
+    if (target >= this->content.size()) {
+        //same position as after n calls of nextChar()
+        this->offset += (int) (this->content.size() - 1 - this->pos);
+        this->pos = (int) this->content.size() - 1;
+        this->current = -1;
+        return;
+    }
+    this->offset += (int) n;
+    this->pos = (int) target;
+    this->current = this->content[target];
+}
 
-    } else if (acc == "Null") {
-        return new NullToken(offset);
+void Lexer::skipSpaces() {
+    if (this->current == ' ') {
+        skipChars(charscan::spaceRun(this->content.data() + this->pos, this->content.size() - this->pos));
+    }
+}
 
-    } else if (acc == "varargs") {
-        return new VarargsKeyword(offset);
+Token* Lexer::nextStringBody() {
+    if (peeked || this->current == -1) {
+        return nullptr;
+    }
+    int startOffset = this->offset;
+    size_t length = charscan::stringBodyRun(this->content.data() + this->pos, this->content.size() - this->pos);
+    if (length == 0) {
+        return nullptr;
+    }
+    auto body = new (*arena) Literal(startOffset, this->content.substr(this->pos, length));
+    skipChars(length);
+    return body;
+}
 
-    } else if (acc == "package") {
-        return new PackageKeyword(offset);
+/**
+ * Keyword lookup dispatching on length and first character, so an identifier is compared with at most
+ * one keyword
+ *
+ * @return keyword token or nullptr if given identifier is not a keyword
+ */
+static Token* resolveKeyword(Arena& arena, int offset, std::string_view acc) {
+    switch (acc.size()) {
+        case 2:
+            switch (acc[0]) {
+                case 'i':
+                    if (acc[1] == 'n') return new (arena) InKeyword(offset);
+                    if (acc[1] == 's') return new (arena) IsKeyword(offset);
+                    if (acc[1] == 'f') return new (arena) IfKeyword(offset);
+                    return nullptr;
+                case 'o':
+                    return acc[1] == 'r' ? new (arena) OrKeyword(offset) : nullptr;
+                default:
+                    return nullptr;
+            }
+        case 3:
+            switch (acc[0]) {
+                case 'f':
+                    if (acc == "fun") return new (arena) FunKeyword(offset);
+                    if (acc == "for") return new (arena) ForKeyword(offset);
+                    return nullptr;
+                case 'v':
+                    if (acc == "var") return new (arena) VarKeyword(offset);
+                    if (acc == "val") return new (arena) ValKeyword(offset);
+                    return nullptr;
+                case 'm':
+                    return acc == "met" ? new (arena) MetKeyword(offset) : nullptr;
+                case 'r':
+                    return acc == "ret" ? new (arena) RetKeyword(offset) : nullptr;
+                case 'l':
+                    return acc == "lam" ? new (arena) LamKeyword(offset) : nullptr;
+                case 'a':
+                    return acc == "and" ? new (arena) AndKeyword(offset) : nullptr;
+                default:
+                    return nullptr;
+            }
+        case 4:
+            switch (acc[0]) {
+                case 'e':
+                    return acc == "else" ? new (arena) ElseKeyword(offset) : nullptr;
+                case 't':
+                    return acc == "true" ? new (arena) TrueKeyword(offset) : nullptr;
+                case 'N':
+                    return acc == "Null" ? new (arena) NullToken(offset) : nullptr;
+                default:
+                    return nullptr;
+            }
+        case 5:
+            switch (acc[0]) {
+                case 'w':
+                    return acc == "while" ? new (arena) WhileKeyword(offset) : nullptr;
+                case 'b':
+                    return acc == "break" ? new (arena) BreakKeyword(offset) : nullptr;
+                case 'f':
+                    return acc == "false" ? new (arena) FalseKeyword(offset) : nullptr;
+                case 't':
+                    return acc == "trait" ? new (arena) TraitKeyword(offset) : nullptr;
+                default:
+                    return nullptr;
+            }
+        case 6:
+            switch (acc[0]) {
+                case 'i':
+                    return acc == "import" ? new (arena) ImportKeyword(offset) : nullptr;
+                case 's':
+                    return acc == "struct" ? new (arena) StructKeyword(offset) : nullptr;
+                default:
+                    return nullptr;
+            }
+        case 7:
+            switch (acc[0]) {
+                case 'v':
+                    return acc == "varargs" ? new (arena) VarargsKeyword(offset) : nullptr;
+                case 'p':
+                    return acc == "package" ? new (arena) PackageKeyword(offset) : nullptr;
+                default:
+                    return nullptr;
+            }
+        case 8:
+            return acc == "continue" ? new (arena) ContinueKeyword(offset) : nullptr;
+        default:
+            return nullptr;
+    }
+}
 
-    } else {
-	    if (isDigit) {
-            return isNumber(offset, acc);
-	    } else {
-            return new Literal(offset, acc);
-	    }
-	}
+static Token* resolveToken(Arena& arena, Interner& interner, int offset, std::string_view acc, bool isDigit) {
+    if (isDigit) {
+        return isNumber(arena, offset, acc);
+    }
+    if (auto keyword = resolveKeyword(arena, offset, acc)) {
+        return keyword;
+    }
+    return new (arena) Literal(offset, acc, interner.intern(acc));
 }
 
 Token* Lexer::peekNext() {
     if (peeked) {
         return this->peekedToken;
     }
+    skipSpaces();
     auto next = getNextToken();
     while (next->isWhitespace()) {
+        skipSpaces();
         next = getNextToken();
     }
     this->peekedToken = next;
@@ -148,11 +190,17 @@ Token* Lexer::peekNext() {
     return this->peekedToken;
 }
 
+void Lexer::scanWord(int startOffset, std::string_view& acc) {
+    size_t run = charscan::wordRun(this->content.data() + this->pos, this->content.size() - this->pos);
+    acc = this->content.substr(startOffset, acc.size() + run);
+    skipChars(run);
+}
+
 Token* Lexer::getNextToken() {
     if (peeked) {
         return checkPeeked();
     }
-	std::string acc;
+	std::string_view acc; //view of the source from startOffset
 	bool isDigit = false;
 	Token* token;
 	char next;
@@ -174,14 +222,17 @@ Token* Lexer::getNextToken() {
                 if (acc.empty() && !isDigit) {
                     isDigit = true;
                 }
-                acc += this->current;
-                break;
+                scanWord(startOffset, acc);
+                continue;
             case 0:
                 nextChar();
+                if (acc.empty()) {
+                    startOffset = this->offset;
+                }
                 continue;
             case -1:
                 if (!acc.empty()) {
-                    token = resolveToken(startOffset, acc, isDigit);
+                    token = resolveToken(*arena, *interner, startOffset, acc, isDigit);
                     goto loopEnd;
                 }
                 eofT->setStartOffset(startOffset);
@@ -193,252 +244,253 @@ Token* Lexer::getNextToken() {
                     nextChar();
                 }
                 else {
-                    token = resolveToken(startOffset, acc, isDigit);
+                    token = resolveToken(*arena, *interner, startOffset, acc, isDigit);
                 }
                 goto loopEnd;
             case '!':
                 if (acc.empty()) {
                     next = nextChar();
                     if (next == '=') {
-                        token = new NotEqualOp(startOffset);
+                        token = new (*arena) NotEqualOp(startOffset);
                         nextChar();
                     } else {
-                        token = new NotOp(startOffset);
+                        token = new (*arena) NotOp(startOffset);
                     }
                 }
                 else {
-                    token = resolveToken(startOffset, acc, isDigit);
+                    token = resolveToken(*arena, *interner, startOffset, acc, isDigit);
                 }
                 goto loopEnd;
             case '<':
                 if (acc.empty()) {
                     next = nextChar();
                     if (next == '=') {
-                        token = new LesserOrEqual(startOffset);
+                        token = new (*arena) LesserOrEqual(startOffset);
                         nextChar();
                     } else {
-                        token = new Lesser(startOffset);
+                        token = new (*arena) Lesser(startOffset);
                     }
                 }
                 else {
-                    token = resolveToken(startOffset, acc, isDigit);
+                    token = resolveToken(*arena, *interner, startOffset, acc, isDigit);
                 }
                 goto loopEnd;
             case '>':
                 if (acc.empty()) {
                     next = nextChar();
                     if (next == '=') {
-                        token = new GreaterOrEqual(startOffset);
+                        token = new (*arena) GreaterOrEqual(startOffset);
                         nextChar();
                     } else {
-                        token = new Greater(startOffset);
+                        token = new (*arena) Greater(startOffset);
                     }
                 }
                 else {
-                    token = resolveToken(startOffset, acc, isDigit);
+                    token = resolveToken(*arena, *interner, startOffset, acc, isDigit);
                 }
                 goto loopEnd;
             case '-':
                 if (acc.empty()) {
                     next = nextChar();
                     if (next == '>') {
-                        token = new Arrow(startOffset);
+                        token = new (*arena) Arrow(startOffset);
                         nextChar();
                     }
                     else {
-                        token = new Sub(startOffset);
+                        token = new (*arena) Sub(startOffset);
                     }
                 }
                 else {
                     if (isDigit && acc.at(acc.size()-1) == 'e') {
-                        acc += this->current;
+                        acc = this->content.substr(startOffset, acc.size() + 1);
                         break;
                     } else {
-                        token = resolveToken(startOffset, acc, isDigit);
+                        token = resolveToken(*arena, *interner, startOffset, acc, isDigit);
                     }
                 }
                 goto loopEnd;
             case '\n':
                 if (acc.empty()) {
-                    token = new NewLine(startOffset);
+                    token = new (*arena) NewLine(startOffset);
                     nextChar();
                 }
                 else {
-                    token = resolveToken(startOffset, acc, isDigit);
+                    token = resolveToken(*arena, *interner, startOffset, acc, isDigit);
                 }
                 goto loopEnd;
             case '.':
                 if (acc.empty()) {
-                    token = new Dot(startOffset);
+                    token = new (*arena) Dot(startOffset);
                     nextChar();
                 } else {
                     if (isDigit) {
-                        acc += this->current;
+                        acc = this->content.substr(startOffset, acc.size() + 1);
                         break;
                     }
-                    token = resolveToken(startOffset, acc, isDigit);
+                    token = resolveToken(*arena, *interner, startOffset, acc, isDigit);
                 }
                 goto loopEnd;
             case ';':
                 if (acc.empty()) {
-                    token = new Semicolon(startOffset);
+                    token = new (*arena) Semicolon(startOffset);
                     nextChar();
                 }
                 else {
-                    token = resolveToken(startOffset, acc, isDigit);
+                    token = resolveToken(*arena, *interner, startOffset, acc, isDigit);
                 }
                 goto loopEnd;
             case '{':
                 if (acc.empty()) {
-                    token = new LeftCurl(startOffset);
+                    token = new (*arena) LeftCurl(startOffset);
                     nextChar();
                 }
                 else {
-                    token = resolveToken(startOffset, acc, isDigit);
+                    token = resolveToken(*arena, *interner, startOffset, acc, isDigit);
                 }
                 goto loopEnd;
             case '}':
                 if (acc.empty()) {
-                    token = new RightCurl(startOffset);
+                    token = new (*arena) RightCurl(startOffset);
                     nextChar();
                 }
                 else {
-                    token = resolveToken(startOffset, acc, isDigit);
+                    token = resolveToken(*arena, *interner, startOffset, acc, isDigit);
                 }
                 goto loopEnd;
             case '=':
                 if (acc.empty()) {
                     next = nextChar();
                     if (next == '=') {
-                        token = new EqualOp(startOffset);
+                        token = new (*arena) EqualOp(startOffset);
                         nextChar();
                     } else {
-                        token = new AssignOp(startOffset);
+                        token = new (*arena) AssignOp(startOffset);
                     }
                 }
                 else {
-                    token = resolveToken(startOffset, acc, isDigit);
+                    token = resolveToken(*arena, *interner, startOffset, acc, isDigit);
                 }
                 goto loopEnd;
             case '(':
                 if (acc.empty()) {
-                    token = new LeftParenthesis(startOffset);
+                    token = new (*arena) LeftParenthesis(startOffset);
                     nextChar();
                 }
                 else {
-                    token = resolveToken(startOffset, acc, isDigit);
+                    token = resolveToken(*arena, *interner, startOffset, acc, isDigit);
                 }
                 goto loopEnd;
             case ')':
                 if (acc.empty()) {
-                    token = new RightParenthesis(startOffset);
+                    token = new (*arena) RightParenthesis(startOffset);
                     nextChar();
                 }
                 else {
-                    token = resolveToken(startOffset, acc, isDigit);
+                    token = resolveToken(*arena, *interner, startOffset, acc, isDigit);
                 }
                 goto loopEnd;
             case '[':
                 if (acc.empty()) {
-                    token = new LeftBracket(startOffset);
+                    token = new (*arena) LeftBracket(startOffset);
                     nextChar();
                 }
                 else {
-                    token = resolveToken(startOffset, acc, isDigit);
+                    token = resolveToken(*arena, *interner, startOffset, acc, isDigit);
                 }
                 goto loopEnd;
             case ']':
                 if (acc.empty()) {
-                    token = new RightBracket(startOffset);
+                    token = new (*arena) RightBracket(startOffset);
                     nextChar();
                 }
                 else {
-                    token = resolveToken(startOffset, acc, isDigit);
+                    token = resolveToken(*arena, *interner, startOffset, acc, isDigit);
                 }
                 goto loopEnd;
             case ',':
                 if (acc.empty()) {
-                    token = new Comma(startOffset);
+                    token = new (*arena) Comma(startOffset);
                     nextChar();
                 }
                 else {
-                    token = resolveToken(startOffset, acc, isDigit);
+                    token = resolveToken(*arena, *interner, startOffset, acc, isDigit);
                 }
                 goto loopEnd;
             case ':':
                 if (acc.empty()) {
-                    token = new Colon(startOffset);
+                    token = new (*arena) Colon(startOffset);
                     nextChar();
                 }
                 else {
-                    token = resolveToken(startOffset, acc, isDigit);
+                    token = resolveToken(*arena, *interner, startOffset, acc, isDigit);
                 }
                 goto loopEnd;
             case '"':
                 if (acc.empty()) {
-                    token = new QuotionMark(startOffset);
+                    token = new (*arena) QuotionMark(startOffset);
                     nextChar();
                 }
                 else {
-                    token = resolveToken(startOffset, acc, isDigit);
+                    token = resolveToken(*arena, *interner, startOffset, acc, isDigit);
                 }
                 goto loopEnd;
             case '/':
                 if (acc.empty()) {
-                    token = new Div(startOffset);
+                    token = new (*arena) Div(startOffset);
                     nextChar();
                 }
                 else {
-                    token = resolveToken(startOffset, acc, isDigit);
+                    token = resolveToken(*arena, *interner, startOffset, acc, isDigit);
                 }
                 goto loopEnd;
             case '\\':
                 if (acc.empty()) {
-                    token = new InverseDiv(startOffset);
+                    token = new (*arena) InverseDiv(startOffset);
                     nextChar();
                 }
                 else {
-                    token = resolveToken(startOffset, acc, isDigit);
+                    token = resolveToken(*arena, *interner, startOffset, acc, isDigit);
                 }
                 goto loopEnd;
             case '*':
                 if (acc.empty()) {
-                    token = new Mul(startOffset);
+                    token = new (*arena) Mul(startOffset);
                     nextChar();
                 }
                 else {
-                    token = resolveToken(startOffset, acc, isDigit);
+                    token = resolveToken(*arena, *interner, startOffset, acc, isDigit);
                 }
                 goto loopEnd;
             case '%':
                 if (acc.empty()) {
-                    token = new Mod(startOffset);
+                    token = new (*arena) Mod(startOffset);
                     nextChar();
                 }
                 else {
-                    token = resolveToken(startOffset, acc, isDigit);
+                    token = resolveToken(*arena, *interner, startOffset, acc, isDigit);
                 }
                 goto loopEnd;
             case '^':
                 if (acc.empty()) {
-                    token = new Pow(startOffset);
+                    token = new (*arena) Pow(startOffset);
                     nextChar();
                 }
                 else {
-                    token = resolveToken(startOffset, acc, isDigit);
+                    token = resolveToken(*arena, *interner, startOffset, acc, isDigit);
                 }
                 goto loopEnd;
             case '+':
                 if (acc.empty()) {
-                    token = new Add(startOffset);
+                    token = new (*arena) Add(startOffset);
                     nextChar();
                 }
                 else {
-                    token = resolveToken(startOffset, acc, isDigit);
+                    token = resolveToken(*arena, *interner, startOffset, acc, isDigit);
                 }
                 goto loopEnd;
             default:
-                acc += this->current;
+                scanWord(startOffset, acc);
+                continue;
             }
         nextChar();
 	}
@@ -468,8 +520,10 @@ Token* Lexer::nextToken() {
     if (peeked) {
         return checkPeeked();
     }
+    skipSpaces();
     auto t = getNextToken();
     while (t->isWhitespace()) {
+        skipSpaces();
         t = getNextToken();
     }
     this->currentToken = t;
@@ -500,8 +554,8 @@ class unsupportedNumberFormat: public std::exception
 public:
     std::string message;
 
-    explicit unsupportedNumberFormat(const std::string& text) {
-        this->message = "Unsupported number format: " + text;
+    explicit unsupportedNumberFormat(std::string_view text) {
+        this->message = "Unsupported number format: " + std::string(text);
     }
 
     const char* what() const noexcept override
@@ -510,7 +564,7 @@ public:
     }
 };
 
-inline Literal* isNumber(int offset, const std::string& text) {
+inline Literal* isNumber(Arena& arena, int offset, std::string_view text) {
     size_t size = text.size();
     bool allNumbers = true;
     char ch;
@@ -530,7 +584,7 @@ inline Literal* isNumber(int offset, const std::string& text) {
         if (!std::isalnum(ch)) {
             if (i == (size - 1)) {
                 if (ch == 'd' || ch == '.') {
-                    return new DoubleNumber(offset, text, std::stod(text));
+                    return new (arena) DoubleNumber(offset, text, std::stod(std::string(text)));
                 } else {
                     throw unsupportedNumberFormat(text);
                 }
@@ -552,10 +606,10 @@ inline Literal* isNumber(int offset, const std::string& text) {
 
     if (allNumbers) {
         if (hadDot) {
-            return new DoubleNumber(offset, text, std::stod(text));
+            return new (arena) DoubleNumber(offset, text, std::stod(std::string(text)));
         }
         //TODO float int etc.
-        return new IntNumber(offset, text, strtol(text.c_str(), nullptr, 0));
+        return new (arena) IntNumber(offset, text, strtol(std::string(text).c_str(), nullptr, 0));
     }
 
     throw unsupportedNumberFormat(text);
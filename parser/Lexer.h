@@ -6,7 +6,9 @@
 #define ROC_LANG_LEXER_H
 
 #include "Token.h"
+#include "SourceBuffer.h"
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <iostream>
@@ -14,22 +16,32 @@
 class Lexer {
 private:
     Token* getNextToken();
+
+    /**
+     * Appends the run of identifier/number characters at the current position to acc
+     */
+    void scanWord(int startOffset, std::string_view& acc);
 public:
 	int pos = 0;
 	int offset = 0;
 	char current = 0;
 	bool peeked = false;
 	Token* peekedToken = nullptr;
-	std::string content;
+	std::shared_ptr<SourceBuffer> buffer;
+	std::shared_ptr<Arena> arena = std::make_shared<Arena>();
+	std::shared_ptr<Interner> interner = std::make_shared<Interner>(); //identifiers of the compilation
+	std::string_view content; //view of the buffer
     std::string filePath;
 	Token* currentToken = nullptr;
-    Eof* eofT = new Eof(0);
-    Space* spaceT = new Space(0);
+    Eof* eofT = new (*arena) Eof(0);
+    Space* spaceT = new (*arena) Space(0);
 
     explicit Lexer(const std::string& filePath);
 
 	Lexer(std::string content, std::string filePath);
 
+	Lexer(std::shared_ptr<SourceBuffer> buffer, std::string filePath);
+
 	~Lexer() {
         //delete eofT;
         //delete spaceT;
@@ -44,6 +56,20 @@ public:
 
 	char nextChar();
 
+	/**
+	 * Same as calling nextChar() n times
+	 */
+	void skipChars(size_t n);
+
+	void skipSpaces();
+
+	/**
+	 * Scans string literal body up to the closing quotation mark
+	 *
+	 * @return literal viewing the body or nullptr if it's empty
+	 */
+	Token* nextStringBody();
+
 	bool hasNext() const;
 
 	Token* peekNext();
@@ -128,11 +128,16 @@ ModuleParser::ModuleParser(ParseContext* parseContext) {
 }
 
 void ModuleParser::parse() {
-    ParserVisitor parserVisitor;
     auto lexer = this->parseContext->lexer;
+    Arena::Scope arenaScope(lexer->arena.get());
+    ParserVisitor parserVisitor;
     this->parseContext->parseVisitor = &parserVisitor;
     PackageNode* packageNode = nullptr;
     auto peeked = lexer->peekNext();
+    while (peeked->isNewLine()) { //leading empty lines
+        delete lexer->nextToken();
+        peeked = lexer->peekNext();
+    }
     if (peeked->getTokenType() != ElementType::packageKeyword) {
         this->syntaxExceptions.emplace_back("Expected package declaration",
                                             peeked->getStartOffset(),
@@ -159,7 +164,7 @@ void ModuleParser::parse() {
             auto t = lexer->nextToken();
             t->visit(&parserVisitor, this->parseContext);
         } catch (SyntaxException &e) {
-            e.printMessage();
+            e.printMessage(this->parseContext->lexer->content);
             this->syntaxExceptions.push_back(e);
             return;
         }
@@ -176,6 +181,9 @@ void ModuleParser::parse() {
             std::move(parserVisitor.types),
             new StaticBlock(std::move(parserVisitor.expressions))
             );
+    module->sourceBuffer = lexer->buffer;
+    module->arena = lexer->arena;
+    module->interner = lexer->interner;
 
     this->parseContext->moduleDeclarations.push_back(module);
     this->parsed = true;
@@ -218,7 +226,15 @@ inline static std::string repeat(size_t times, char ch) {
 
 void SyntaxException::printMessage() const {
     Lexer lexer(filePath);
+    printMessage(lexer);
+}
+
+void SyntaxException::printMessage(std::string_view source) const {
+    Lexer lexer(std::string(source), filePath);
+    printMessage(lexer);
+}
 
+void SyntaxException::printMessage(Lexer& lexer) const {
     bool markerMode = false;
     std::string marker;
     std::string lineAcc;
@@ -9,6 +9,7 @@
 #include <vector>
 #include <memory>
 #include <exception>
+#include <string_view>
 
 #include "Token.h"
 #include "Lexer.h"
@@ -154,6 +155,14 @@ public:
                     std::string filePath);
 
     virtual void printMessage() const;
+
+    /**
+     * Prints the message using given source instead of reading it from the file path
+     */
+    virtual void printMessage(std::string_view source) const;
+
+private:
+    void printMessage(Lexer& lexer) const;
 };
 
 #endif
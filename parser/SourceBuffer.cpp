@@ -0,0 +1,24 @@
+#include "SourceBuffer.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+SourceBuffer::SourceBuffer() = default;
+
+SourceBuffer::~SourceBuffer() = default;
+
+std::shared_ptr<SourceBuffer> SourceBuffer::fromFile(const std::string& filePath) {
+    auto fileOrError = llvm::MemoryBuffer::getFile(filePath);
+    if (!fileOrError) {
+        return nullptr;
+    }
+    auto result = std::make_shared<SourceBuffer>();
+    result->mapped = std::move(fileOrError.get());
+    result->text = std::string_view(result->mapped->getBufferStart(), result->mapped->getBufferSize());
+    return result;
+}
+
+std::shared_ptr<SourceBuffer> SourceBuffer::fromString(std::string content) {
+    auto result = std::make_shared<SourceBuffer>();
+    result->owned = std::move(content);
+    result->text = result->owned;
+    return result;
+}
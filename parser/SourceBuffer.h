@@ -0,0 +1,41 @@
+#pragma once
+#ifndef ROC_LANG_SOURCEBUFFER_H
+#define ROC_LANG_SOURCEBUFFER_H
+
+#include <string>
+#include <string_view>
+#include <memory>
+
+namespace llvm {
+    class MemoryBuffer;
+};
+
+/**
+ * Read-only source text of a module. Files are memory mapped (via llvm::MemoryBuffer) so large inputs
+ * are not copied, in-memory sources are owned by the buffer. Shared between the lexer and the compilation
+ * which reports problems against it.
+ */
+class SourceBuffer {
+private:
+    std::unique_ptr<llvm::MemoryBuffer> mapped;
+    std::string owned;
+    std::string_view text;
+
+public:
+    SourceBuffer();
+
+    ~SourceBuffer();
+
+    /**
+     * @return mapped content of the given file or nullptr if it can't be opened
+     */
+    static std::shared_ptr<SourceBuffer> fromFile(const std::string& filePath);
+
+    static std::shared_ptr<SourceBuffer> fromString(std::string content);
+
+    std::string_view getText() const {
+        return text;
+    }
+};
+
+#endif //ROC_LANG_SOURCEBUFFER_H
@@ -424,12 +424,16 @@ void LamKeyword::visit(TokenVisitor *tokenVisitor, VisitingContext *context) {
     tokenVisitor->visit(this, context);
 }
 
-Literal::Literal(int startOffset, std::string content) : Token(startOffset, ElementType::literal) {
-    this->content = std::move(content);
+Literal::Literal(int startOffset, std::string_view content) : Token(startOffset, ElementType::literal) {
+    this->content = content;
+}
+
+Literal::Literal(int startOffset, std::string_view content, SymbolId symbol) : Literal(startOffset, content) {
+    this->symbol = symbol;
 }
 
 std::string Literal::getText() {
-    return this->content;
+    return std::string(this->content);
 }
 
 void Literal::visit(TokenVisitor *tokenVisitor, VisitingContext *context) {
@@ -439,7 +443,7 @@ void Literal::visit(TokenVisitor *tokenVisitor, VisitingContext *context) {
 TraitKeyword::TraitKeyword(int startOffset) : Token(startOffset, ElementType::interfaceKeyword) {}
 
 std::string TraitKeyword::getText() {
-    return this->content;
+    return "trait";
 }
 
 void TraitKeyword::visit(TokenVisitor *tokenVisitor, VisitingContext *context) {
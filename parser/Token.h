@@ -6,11 +6,14 @@
 #define ROC_LANG_TOKEN_H
 
 #include <string>
+#include <string_view>
 #include <memory>
 #include <map>
 #include <utility>
 #include <utility>
 #include <vector>
+#include "Arena.h"
+#include "Interner.h"
 
 class TokenVisitor;
 class VisitingContext;
@@ -177,7 +180,7 @@ enum ElementType {
 };
 
 /**
- * Base Token class
+ * Base Token class, tokens are allocated from the Arena of the lexer
  */
 class Token {
 protected:
@@ -189,6 +192,17 @@ public:
 
     virtual ~Token() = default;
 
+    void* operator new(size_t size, Arena& arena) {
+        return arena.allocate(size);
+    }
+
+    /**
+     * Storage is owned by the arena
+     */
+    void operator delete(void*) {}
+
+    void operator delete(void*, Arena&) {}
+
     /**
      * Get string representation of token
      *
@@ -440,9 +454,12 @@ public:
 
 class Literal : public Token {
 public:
-    std::string content;
+    std::string_view content; //view of the source buffer
+    SymbolId symbol = noSymbol; //set by the lexer for identifiers
+
+    Literal(int startOffset, std::string_view content);
 
-    Literal(int startOffset, std::string content);
+    Literal(int startOffset, std::string_view content, SymbolId symbol);
 
     std::string getText() override;
 
@@ -455,8 +472,6 @@ public:
 
 class StructKeyword : public Token {
 public:
-    std::string content;
-
     StructKeyword(int startOffset);
 
     std::string getText() override;
@@ -466,8 +481,6 @@ public:
 
 class TraitKeyword : public Token {
 public:
-    std::string content;
-
     TraitKeyword(int startOffset);
 
     std::string getText() override;
@@ -479,7 +492,7 @@ class IntNumber : public Literal {
 public:
     int value;
 
-    IntNumber(int startOffset, std::string content, int value) : Literal(startOffset, std::move(content)) {
+    IntNumber(int startOffset, std::string_view content, int value) : Literal(startOffset, content) {
         this->value = value;
     };
 
@@ -490,7 +503,7 @@ class DoubleNumber : public Literal {
 public:
     double value;
 
-    DoubleNumber(int startOffset, std::string content, double value) : Literal(startOffset, std::move(content)) {
+    DoubleNumber(int startOffset, std::string_view content, double value) : Literal(startOffset, content) {
         this->value = value;
     };
 
@@ -0,0 +1,330 @@
+#include "ControlFlowPass.h"
+
+#include <algorithm>
+#include <set>
+
+static MIRBasicBlock* intersect(MIRBasicBlock *a, MIRBasicBlock *b) {
+    while (a != b) {
+        while (a->order > b->order) {
+            a = a->immediateDominator;
+        }
+        while (b->order > a->order) {
+            b = b->immediateDominator;
+        }
+    }
+    return a;
+}
+
+void computeDominators(MIRFunction *mirFunction) {
+    auto& blocks = mirFunction->blocks;
+    for (auto& block: blocks) {
+        block->predecessors.clear();
+        block->immediateDominator = nullptr;
+        block->order = -1;
+    }
+    for (auto& block: blocks) {
+        for (auto& successor: block->successors) {
+            successor->predecessors.push_back(block);
+        }
+    }
+    if (blocks.empty()) {
+        return;
+    }
+
+    std::vector<MIRBasicBlock*> postOrder;
+    std::set<MIRBasicBlock*> visited;
+    std::vector<std::pair<MIRBasicBlock*, size_t>> stack;
+    stack.emplace_back(blocks.front(), 0);
+    visited.insert(blocks.front());
+    while (!stack.empty()) {
+        auto& top = stack.back();
+        if (top.second < top.first->successors.size()) {
+            auto successor = top.first->successors[top.second++];
+            if (visited.insert(successor).second) {
+                stack.emplace_back(successor, 0);
+            }
+        } else {
+            postOrder.push_back(top.first);
+            stack.pop_back();
+        }
+    }
+
+    std::vector<MIRBasicBlock*> reversePostOrder(postOrder.rbegin(), postOrder.rend());
+    for (int i = 0; i < reversePostOrder.size(); i++) {
+        reversePostOrder[i]->order = i;
+    }
+
+    auto entry = reversePostOrder.front();
+    entry->immediateDominator = entry;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int i = 1; i < reversePostOrder.size(); i++) {
+            auto block = reversePostOrder[i];
+            MIRBasicBlock* newDominator = nullptr;
+            for (auto& predecessor: block->predecessors) {
+                if (predecessor->order == -1 || predecessor->immediateDominator == nullptr) {
+                    continue;
+                }
+                newDominator = newDominator ? intersect(predecessor, newDominator) : predecessor;
+            }
+            if (newDominator != block->immediateDominator) {
+                block->immediateDominator = newDominator;
+                changed = true;
+            }
+        }
+    }
+    entry->immediateDominator = nullptr;
+}
+
+void ControlFlowGraphBuilder::visit(MIRFunction *mirFunction) {
+    this->currentFunction = mirFunction;
+    mirFunction->blocks.clear();
+    auto exit = lowerValues(newBlock("entry"), mirFunction->body->values);
+    if (!exit->isTerminated()) {
+        throw "Function body doesn't end with a return";
+    }
+    computeDominators(mirFunction);
+}
+
+MIRBasicBlock* ControlFlowGraphBuilder::newBlock(const std::string &name) {
+    auto block = new MIRBasicBlock(this->currentFunction->blocks.size(), name);
+    block->parent = this->currentFunction;
+    this->currentFunction->blocks.push_back(block);
+    return block;
+}
+
+MIRBasicBlock* ControlFlowGraphBuilder::lowerValues(MIRBasicBlock *current, const std::vector<MIRValue*> &values) {
+    for (auto& value: values) {
+        if (current->isTerminated()) {
+            current = newBlock("unreachable"); //code after return, removed by DeadCodeElimination
+        }
+        if (value->isIf()) {
+            current = lowerIf(current, (MIRIf*) value);
+        } else {
+            current->values.push_back(value);
+            value->parent = current;
+        }
+    }
+    return current;
+}
+
+MIRBasicBlock* ControlFlowGraphBuilder::lowerIf(MIRBasicBlock *current, MIRIf *mirIf) {
+    current->condition = mirIf->condition;
+    current->condition->parent = current;
+
+    auto thenBlock = newBlock("if-start");
+    current->successors.push_back(thenBlock);
+    auto thenExit = lowerValues(thenBlock, mirIf->block->values);
+
+    MIRBasicBlock* elseExit = nullptr;
+    if (mirIf->hasNextBlock()) {
+        auto elseBlock = newBlock("else-start");
+        current->successors.push_back(elseBlock);
+        if (mirIf->elseBlock->block) {
+            elseExit = lowerValues(elseBlock, mirIf->elseBlock->block->values);
+        } else {
+            elseExit = lowerIf(elseBlock, mirIf->elseBlock->ifBlock);
+        }
+    }
+
+    auto endBlock = newBlock("if-end");
+    if (!mirIf->hasNextBlock()) {
+        current->successors.push_back(endBlock);
+    }
+    if (!thenExit->isTerminated()) {
+        thenExit->successors.push_back(endBlock);
+    }
+    if (elseExit && !elseExit->isTerminated()) {
+        elseExit->successors.push_back(endBlock);
+    }
+    return endBlock;
+}
+
+/**
+ * @return true if both operands are constants, their values are stored in left and right
+ */
+static bool constantOperands(MIRBinOpBase *node, long long &left, long long &right) {
+    if (!node->left->isConstant() || !node->right->isConstant()) {
+        return false;
+    }
+    left = node->left->getConstantValue();
+    right = node->right->getConstantValue();
+    return true;
+}
+
+void ConstantPropagation::visit(MIRFunction *mirFunction) {
+    MIRVisitor::visit(mirFunction);
+    for (auto& block: mirFunction->blocks) {
+        if (block->condition && block->condition->expr->isConstant()) {
+            auto target = block->successors[block->condition->expr->getConstantValue() ? 0 : 1];
+            block->condition = nullptr;
+            block->successors = {target};
+            this->foldedBranches++;
+        }
+    }
+    computeDominators(mirFunction);
+}
+
+void ConstantPropagation::foldInt32(MIRBinOpBase *node, long long value) {
+    //Int32 arithmetic wraps around like the generated code
+    node->parent->replaceChild(node, new MIRConstantInt((int32_t) (uint32_t) value));
+    this->foldedConstants++;
+}
+
+void ConstantPropagation::foldBool(MIRBinOpBase *node, bool value) {
+    node->parent->replaceChild(node, value ? (MIRValue*) new MIRTrue() : new MIRFalse());
+    this->foldedConstants++;
+}
+
+void ConstantPropagation::visit(MIRInt32Add *node) {
+    MIRVisitor::visit(node);
+    long long left, right;
+    if (constantOperands(node, left, right)) foldInt32(node, left + right);
+}
+
+void ConstantPropagation::visit(MIRInt32Sub *node) {
+    MIRVisitor::visit(node);
+    long long left, right;
+    if (constantOperands(node, left, right)) foldInt32(node, left - right);
+}
+
+void ConstantPropagation::visit(MIRInt32Mul *node) {
+    MIRVisitor::visit(node);
+    long long left, right;
+    if (constantOperands(node, left, right)) foldInt32(node, left * right);
+}
+
+void ConstantPropagation::visit(MIRInt32Mod *node) {
+    MIRVisitor::visit(node);
+    long long left, right;
+    if (constantOperands(node, left, right) && right != 0) foldInt32(node, left % right);
+}
+
+void ConstantPropagation::visit(MIRInt32Eq *node) {
+    MIRVisitor::visit(node);
+    long long left, right;
+    if (constantOperands(node, left, right)) foldBool(node, left == right);
+}
+
+void ConstantPropagation::visit(MIRInt32NotEq *node) {
+    MIRVisitor::visit(node);
+    long long left, right;
+    if (constantOperands(node, left, right)) foldBool(node, left != right);
+}
+
+void ConstantPropagation::visit(MIRInt32Gt *node) {
+    MIRVisitor::visit(node);
+    long long left, right;
+    if (constantOperands(node, left, right)) foldBool(node, left > right);
+}
+
+void ConstantPropagation::visit(MIRInt32Lt *node) {
+    MIRVisitor::visit(node);
+    long long left, right;
+    if (constantOperands(node, left, right)) foldBool(node, left < right);
+}
+
+void ConstantPropagation::visit(MIRInt32Ge *node) {
+    MIRVisitor::visit(node);
+    long long left, right;
+    if (constantOperands(node, left, right)) foldBool(node, left >= right);
+}
+
+void ConstantPropagation::visit(MIRInt32Le *node) {
+    MIRVisitor::visit(node);
+    long long left, right;
+    if (constantOperands(node, left, right)) foldBool(node, left <= right);
+}
+
+void ConstantPropagation::visit(MIRAnd *node) {
+    MIRVisitor::visit(node);
+    long long left, right;
+    if (constantOperands(node, left, right) && node->left->getType()->typeEnum == TypeEnum::boolType) {
+        foldBool(node, left && right);
+    }
+}
+
+void ConstantPropagation::visit(MIROr *node) {
+    MIRVisitor::visit(node);
+    long long left, right;
+    if (constantOperands(node, left, right) && node->left->getType()->typeEnum == TypeEnum::boolType) {
+        foldBool(node, left || right);
+    }
+}
+
+static bool hasSideEffects(MIRValue *value) {
+    if (value->hasSideEffects()) {
+        return true;
+    }
+    for (auto& child: value->getChildren()) {
+        if (hasSideEffects(child)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void DeadCodeElimination::visit(MIRFunction *mirFunction) {
+    computeDominators(mirFunction);
+
+    std::vector<MIRBasicBlock*> reachable;
+    for (auto& block: mirFunction->blocks) {
+        if (block->order == -1) {
+            this->eliminatedBlocks++;
+        } else {
+            reachable.push_back(block);
+        }
+    }
+    //reverse post order puts every block after its immediate dominator
+    std::sort(reachable.begin(), reachable.end(), [](MIRBasicBlock* a, MIRBasicBlock* b) {
+        return a->order < b->order;
+    });
+    mirFunction->blocks = std::move(reachable);
+    computeDominators(mirFunction);
+
+    //a block which is the only target of a jump continues its predecessor
+    std::set<MIRBasicBlock*> merged;
+    for (auto& block: mirFunction->blocks) {
+        if (merged.count(block)) {
+            continue;
+        }
+        while (block->condition == nullptr && block->successors.size() == 1) {
+            auto next = block->successors.front();
+            if (next == block || next->predecessors.size() != 1) {
+                break;
+            }
+            for (auto& value: next->values) {
+                block->values.push_back(value);
+                value->parent = block;
+            }
+            block->condition = next->condition;
+            if (block->condition) {
+                block->condition->parent = block;
+            }
+            block->successors = next->successors;
+            merged.insert(next);
+            this->mergedBlocks++;
+        }
+    }
+    std::vector<MIRBasicBlock*> remaining;
+    for (auto& block: mirFunction->blocks) {
+        if (!merged.count(block)) {
+            remaining.push_back(block);
+        }
+    }
+    mirFunction->blocks = std::move(remaining);
+
+    for (auto& block: mirFunction->blocks) {
+        std::vector<MIRValue*> values;
+        for (auto& value: block->values) {
+            if (value->isReturn() || hasSideEffects(value)) {
+                values.push_back(value);
+            } else {
+                this->eliminatedValues++;
+            }
+        }
+        block->values = std::move(values);
+    }
+    computeDominators(mirFunction);
+}
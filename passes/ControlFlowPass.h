@@ -0,0 +1,85 @@
+#pragma once
+#ifndef ROC_LANG_CONTROLFLOWPASS_H
+#define ROC_LANG_CONTROLFLOWPASS_H
+
+#include "../mir/MIR.h"
+
+/**
+ * Recomputes predecessors, reverse post order and immediate dominators (Cooper, Harvey, Kennedy) of the
+ * function's basic blocks, blocks not reachable from the entry block get order -1
+ */
+void computeDominators(MIRFunction *mirFunction);
+
+/**
+ * Lowers the structured body of every function (nested MIRIf/MIRElse) into MIRFunction::blocks.
+ * Expression trees stay as they are, each node is a value defined once and used by its parent
+ */
+class ControlFlowGraphBuilder : public MIRVisitor {
+public:
+    void visit(MIRFunction *mirFunction) override;
+
+private:
+    MIRFunction *currentFunction = nullptr;
+
+    MIRBasicBlock *newBlock(const std::string &name);
+
+    MIRBasicBlock *lowerValues(MIRBasicBlock *current, const std::vector<MIRValue *> &values);
+
+    MIRBasicBlock *lowerIf(MIRBasicBlock *current, MIRIf *mirIf);
+};
+
+/**
+ * Folds Int32 arithmetic, comparisons and boolean operators with constant operands and turns branches
+ * on constant conditions into jumps
+ */
+class ConstantPropagation : public MIRVisitor {
+public:
+    int foldedConstants = 0;
+    int foldedBranches = 0;
+
+    void visit(MIRFunction *mirFunction) override;
+
+    void visit(MIRInt32Add *node) override;
+
+    void visit(MIRInt32Sub *node) override;
+
+    void visit(MIRInt32Mul *node) override;
+
+    void visit(MIRInt32Mod *node) override;
+
+    void visit(MIRInt32Eq *node) override;
+
+    void visit(MIRInt32NotEq *node) override;
+
+    void visit(MIRInt32Gt *node) override;
+
+    void visit(MIRInt32Lt *node) override;
+
+    void visit(MIRInt32Ge *node) override;
+
+    void visit(MIRInt32Le *node) override;
+
+    void visit(MIRAnd *node) override;
+
+    void visit(MIROr *node) override;
+
+private:
+    void foldInt32(MIRBinOpBase *node, long long value);
+
+    void foldBool(MIRBinOpBase *node, bool value);
+};
+
+/**
+ * Removes basic blocks which are not reachable from the entry block and values without side effects
+ * whose result is never used, merges jump chains left behind into single blocks
+ */
+class DeadCodeElimination : public MIRVisitor {
+public:
+    int eliminatedBlocks = 0;
+    int mergedBlocks = 0;
+    int eliminatedValues = 0;
+
+    void visit(MIRFunction *mirFunction) override;
+};
+
+#endif //ROC_LANG_CONTROLFLOWPASS_H
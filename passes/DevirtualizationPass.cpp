@@ -0,0 +1,67 @@
+#include "DevirtualizationPass.h"
+#include "../compiler/Extensions.h"
+
+/**
+ * @return name of the function implementing given method for the receiver type or empty string if unknown
+ */
+std::string findDirectTarget(RocType *receiverType, SymbolId method, int args) {
+    auto typeId = receiverType->typeId();
+    if (typeId != rocInt32TypeId && typeId != rocRawStringTypeId) {
+        return "";
+    }
+    if (method == roc::symbols::toStringName && args == 0) {
+        return receiverType->prettyName() + ".toString." + std::to_string(args);
+    }
+    return "";
+}
+
+void Devirtualizer::visit(MIRBlock *mirBlock) {
+    for (int i = 0; i < mirBlock->values.size(); i++) {
+        mirBlock->values[i]->accept(this);
+    }
+}
+
+void Devirtualizer::visit(MIRCCall *mircCall) {
+    Devirtualizer::visit((MIRFunctionCall*) mircCall);
+}
+
+void Devirtualizer::visit(MIRFunctionCall *mirFunctionCall) {
+    for (int i = 0; i < mirFunctionCall->arguments.size(); i++) {
+        mirFunctionCall->arguments[i]->accept(this);
+    }
+}
+
+void Devirtualizer::visit(MIRFunctionInstanceCall *mirFunctionCall) {
+    mirFunctionCall->caller->accept(this);
+    Devirtualizer::visit((MIRFunctionCall*) mirFunctionCall);
+
+    auto receiverType = mirFunctionCall->caller->getType();
+    auto target = findDirectTarget(receiverType, mirFunctionCall->symbol, mirFunctionCall->arguments.size());
+    if (target.empty() || mirFunctionCall->parent == nullptr) {
+        return;
+    }
+
+    //receiver becomes the first argument of the direct call
+    std::vector<RocType*> argumentTypes;
+    argumentTypes.push_back(receiverType);
+    std::vector<MIRValue*> arguments;
+    arguments.push_back(mirFunctionCall->caller);
+    for (auto& arg: mirFunctionCall->arguments) {
+        argumentTypes.push_back(arg->getType());
+        arguments.push_back(arg);
+    }
+    auto targetCall = new PredefinedTargetMethodCall(receiverType,
+                                                     target,
+                                                     target,
+                                                     argumentTypes,
+                                                     mirFunctionCall->getType());
+    //Int32 toString allocates the string, raw strings return themselves
+    targetCall->newObject = receiverType->typeId() == rocInt32TypeId;
+    auto directCall = new MIRFunctionCall(target, arguments, targetCall);
+    mirFunctionCall->parent->replaceChild(mirFunctionCall, directCall);
+    this->devirtualizedCalls++;
+}
+
+void Devirtualizer::visit(MIRCastTo *mirCastTo) {
+    mirCastTo->from->accept(this);
+}
@@ -0,0 +1,26 @@
+#pragma once
+#ifndef ROC_LANG_DEVIRTUALIZATIONPASS_H
+#define ROC_LANG_DEVIRTUALIZATIONPASS_H
+
+#include "../mir/MIR.h"
+
+/**
+ * Rewrites instance calls on receivers with statically known builtin type (Int32, StringRaw)
+ * to direct calls of the implementing function i.e. a.toString() -> Int32.toString.0(a)
+ */
+class Devirtualizer : public MIRVisitor {
+public:
+    int devirtualizedCalls = 0;
+
+    void visit(MIRBlock *mirBlock) override;
+
+    void visit(MIRCCall *mircCall) override;
+
+    void visit(MIRFunctionCall *mirFunctionCall) override;
+
+    void visit(MIRFunctionInstanceCall *mirFunctionCall) override;
+
+    void visit(MIRCastTo *mirCastTo) override;
+};
+
+#endif //ROC_LANG_DEVIRTUALIZATIONPASS_H
@@ -13,7 +13,7 @@ void HeapAllocatorLifter::visit(MIRInt32Array *mirInt32Array) {
 }
 
 void LabelResolver::visitIf(MIRIf *mirIf) {
-    mirIf->endLabel = new MIRLabel(labelCounter++, "if-start");
+    mirIf->startLabel = new MIRLabel(labelCounter++, "if-start");
     mirIf->endLabel = new MIRLabel(labelCounter++, "if-false");
     mirIf->block->accept(this);
     if (mirIf->hasNextBlock()) {
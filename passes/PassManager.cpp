@@ -0,0 +1,159 @@
+#include "PassManager.h"
+
+#include <chrono>
+#include <set>
+#include <stdexcept>
+#include "../parser/Arena.h"
+#include "DevirtualizationPass.h"
+#include "ControlFlowPass.h"
+
+class DevirtualizationPass : public MIRVisitorPass<Devirtualizer> {
+public:
+    void report(RocCompilationResult *result) override {
+        result->devirtualizedCalls += visitor.devirtualizedCalls;
+    }
+};
+
+class ConstantPropagationPass : public MIRVisitorPass<ConstantPropagation> {
+public:
+    void report(RocCompilationResult *result) override {
+        result->foldedConstants += visitor.foldedConstants;
+    }
+};
+
+class DeadCodeEliminationPass : public MIRVisitorPass<DeadCodeElimination> {
+public:
+    void report(RocCompilationResult *result) override {
+        result->eliminatedBlocks += visitor.eliminatedBlocks;
+    }
+};
+
+void MIRVerifier::verify(MIRModule *mirModule) {
+    for (auto& f: mirModule->functions) {
+        verify(f.get());
+    }
+}
+
+void MIRVerifier::verify(MIRFunction *mirFunction) {
+    if (mirFunction->blocks.empty()) {
+        verifyTree(mirFunction, mirFunction->body);
+        return;
+    }
+    std::set<MIRBasicBlock*> functionBlocks(mirFunction->blocks.begin(), mirFunction->blocks.end());
+    for (auto& block: mirFunction->blocks) {
+        auto prefix = mirFunction->name + ": block " + block->getText();
+        verifyTree(mirFunction, block);
+        if (!block->isTerminated()) {
+            problems.push_back(prefix + " is not terminated");
+        }
+        if (block->condition && block->successors.size() != 2) {
+            problems.push_back(prefix + " has a condition but " + std::to_string(block->successors.size()) +
+                               " successors");
+        }
+        if (!block->condition && block->successors.size() > 1) {
+            problems.push_back(prefix + " branches without a condition");
+        }
+        for (auto& successor: block->successors) {
+            if (functionBlocks.count(successor) == 0) {
+                problems.push_back(prefix + " branches to a block of another function");
+            }
+        }
+    }
+}
+
+void MIRVerifier::verifyTree(MIRFunction *mirFunction, MIRValue *node) {
+    for (auto& child: node->getChildren()) {
+        if (child == nullptr) {
+            problems.push_back(mirFunction->name + ": null child in " + node->getText());
+            continue;
+        }
+        if (child->parent != node) {
+            problems.push_back(mirFunction->name + ": wrong parent of " + child->getText());
+        }
+        verifyTree(mirFunction, child);
+    }
+}
+
+MIRPassManager::MIRPassManager() {
+    registerPass("devirt", [] { return std::make_unique<DevirtualizationPass>(); });
+    registerPass("constprop", [] { return std::make_unique<ConstantPropagationPass>(); });
+    registerPass("dce", [] { return std::make_unique<DeadCodeEliminationPass>(); });
+}
+
+void MIRPassManager::registerPass(const std::string &name, PassFactory factory) {
+    registry[name] = std::move(factory);
+}
+
+bool MIRPassManager::isRegistered(const std::string &name) const {
+    return registry.find(name) != registry.end();
+}
+
+std::vector<std::string> MIRPassManager::getRegisteredPasses() const {
+    std::vector<std::string> result;
+    for (auto& entry: registry) {
+        result.push_back(entry.first);
+    }
+    return result;
+}
+
+void MIRPassManager::addPass(const std::string &name, std::unique_ptr<MIRPass> pass) {
+    pipeline.emplace_back(name, std::move(pass));
+}
+
+void MIRPassManager::addPasses(const std::string &names) {
+    size_t start = 0;
+    while (start < names.size()) {
+        auto end = names.find(',', start);
+        if (end == std::string::npos) {
+            end = names.size();
+        }
+        auto name = names.substr(start, end - start);
+        start = end + 1;
+        if (name.empty()) {
+            continue;
+        }
+        auto it = registry.find(name);
+        if (it == registry.end()) {
+            std::string known;
+            for (auto& registered: getRegisteredPasses()) {
+                known += (known.empty() ? "" : ", ") + registered;
+            }
+            auto msg = "Unknown MIR pass: " + name + " (known passes: " + known + ")";
+            throw std::runtime_error(msg);
+        }
+        addPass(name, it->second());
+    }
+}
+
+void MIRPassManager::run(MIRModule *mirModule, RocCompilationResult *result) {
+    for (auto& [name, pass]: pipeline) {
+        auto arena = Arena::active;
+        auto allocations = arena ? arena->allocationCount() : 0;
+        auto allocatedBytes = arena ? arena->allocatedSize() : 0;
+        auto start = std::chrono::steady_clock::now();
+
+        {
+            TimeReport::Phase phase(timeReport, name);
+            pass->run(mirModule);
+        }
+
+        MIRPassStatistics passStatistics;
+        passStatistics.name = name;
+        passStatistics.milliseconds = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+        passStatistics.allocations = arena ? arena->allocationCount() - allocations : 0;
+        passStatistics.allocatedBytes = arena ? arena->allocatedSize() - allocatedBytes : 0;
+        statistics.push_back(passStatistics);
+        pass->report(result);
+
+        if (verify) {
+            MIRVerifier verifier;
+            verifier.verify(mirModule);
+            if (!verifier.problems.empty()) {
+                auto msg = "Invalid MIR after " + name + " pass: " + verifier.problems.front();
+                throw std::runtime_error(msg);
+            }
+        }
+    }
+    result->mirPassStatistics = statistics;
+}
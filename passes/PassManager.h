@@ -0,0 +1,111 @@
+#pragma once
+#ifndef ROC_LANG_PASSMANAGER_H
+#define ROC_LANG_PASSMANAGER_H
+
+#include <functional>
+#include <map>
+#include <memory>
+#include "../mir/MIR.h"
+#include "../compiler/RocCompiler.h"
+#include "../compiler/TimeReport.h"
+
+/**
+ * Transformation or analysis of a whole MIR module run by MIRPassManager
+ */
+class MIRPass {
+public:
+    virtual ~MIRPass() = default;
+
+    virtual void run(MIRModule *mirModule) = 0;
+
+    /**
+     * Copies counters of the pass to the compilation result
+     */
+    virtual void report(RocCompilationResult *result) { }
+};
+
+/**
+ * Pass running a visitor over every function of the module
+ */
+template<typename V>
+class MIRVisitorPass : public MIRPass {
+public:
+    V visitor;
+
+    void run(MIRModule *mirModule) override {
+        mirModule->visit(&visitor);
+    }
+};
+
+/**
+ * Pass running a visitor owned elsewhere i.e. the builtin resolver of the compilation context
+ */
+class MIRSharedVisitorPass : public MIRPass {
+public:
+    MIRVisitor *visitor;
+
+    explicit MIRSharedVisitorPass(MIRVisitor *visitor) : visitor(visitor) { }
+
+    void run(MIRModule *mirModule) override {
+        mirModule->visit(visitor);
+    }
+};
+
+/**
+ * Checks structural invariants of MIR: every child points back to its parent and, once the control flow
+ * graph is built, every block is terminated and branches only to blocks of its function
+ */
+class MIRVerifier {
+public:
+    std::vector<std::string> problems; //one message per broken invariant, empty if MIR is valid
+
+    void verify(MIRModule *mirModule);
+
+private:
+    void verify(MIRFunction *mirFunction);
+
+    void verifyTree(MIRFunction *mirFunction, MIRValue *node);
+};
+
+/**
+ * Runs MIR passes in order, optimization passes are registered by name so the command line can pick
+ * and order them (see Config::mirPasses). Measures wall time and MIR allocations of every pass and
+ * optionally verifies MIR after each of them
+ */
+class MIRPassManager {
+public:
+    using PassFactory = std::function<std::unique_ptr<MIRPass>()>;
+
+    bool verify = false;
+    TimeReport *timeReport = nullptr; //every pass is reported as a nested phase if set
+    std::vector<MIRPassStatistics> statistics;
+
+    /**
+     * Registers devirt, constprop and dce
+     */
+    MIRPassManager();
+
+    void registerPass(const std::string &name, PassFactory factory);
+
+    bool isRegistered(const std::string &name) const;
+
+    std::vector<std::string> getRegisteredPasses() const;
+
+    void addPass(const std::string &name, std::unique_ptr<MIRPass> pass);
+
+    /**
+     * Appends registered passes given as comma separated names, throws on unknown name
+     */
+    void addPasses(const std::string &names);
+
+    /**
+     * Runs the pipeline, counters and statistics go to the result
+     */
+    void run(MIRModule *mirModule, RocCompilationResult *result);
+
+private:
+    std::map<std::string, PassFactory> registry;
+    std::vector<std::pair<std::string, std::unique_ptr<MIRPass>>> pipeline;
+};
+
+#endif //ROC_LANG_PASSMANAGER_H
@@ -0,0 +1,10 @@
+package main
+
+fun show(a Int32) {
+    println(a.toString())
+}
+
+fun box() -> Bool {
+    show(4567)
+    ret true
+}
@@ -0,0 +1,282 @@
+#include "Catch.h"
+#include "../compiler/RocCompiler.h"
+#include "../compiler/Types.h"
+#include "../linking/Allocator.h"
+#include "../linking/Output.h"
+#include "../parser/SourceBuffer.h"
+#include "../passes/PassManager.h"
+#include <llvm/ExecutionEngine/ExecutionEngine.h>
+#include <fstream>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+
+TEST_CASE("Compile source from memory", "[compileSource]") {
+    std::string source = "package main\n"
+                         "fun test(a Int32) -> Int32 {\n"
+                         "  ret a + 1\n"
+                         "}\n";
+    auto result = RocCompiler::compileSource(source, "InMemory.roc");
+    if (result) {
+        auto ref = (int (*)(int)) result->EE->getFunctionAddress("test");
+        REQUIRE(ref(41) == 42);
+        REQUIRE_FALSE(std::ifstream("InMemory.roc").good());
+    } else {
+        REQUIRE(false);
+    }
+
+    Config config;
+    config.outputMode = emitAsm;
+    config.srcOutput = "compileSource.s";
+    std::remove("compileSource.s");
+    result = RocCompiler::compileSource(source, "InMemory.roc", config);
+    REQUIRE(result != nullptr);
+    REQUIRE(result->EE == nullptr);
+    REQUIRE(std::ifstream("compileSource.s").good());
+}
+
+TEST_CASE("Emit object file and IR without JIT", "[outputMode]") {
+    std::string source = "package main\n"
+                         "fun test(a Int32) -> Int32 {\n"
+                         "  ret a + 1\n"
+                         "}\n";
+    Config config;
+    config.outputMode = emitObj;
+    std::remove("output.o");
+    auto result = RocCompiler::compileSource(source, "Emit.roc", config);
+    REQUIRE(result != nullptr);
+    REQUIRE(result->EE == nullptr);
+    REQUIRE(std::ifstream("output.o").good());
+
+    config.outputMode = emitIR;
+    config.srcOutput = "emit.ll";
+    result = RocCompiler::compileSource(source, "Emit.roc", config);
+    REQUIRE(result != nullptr);
+    std::ifstream ir("emit.ll");
+    std::string text((std::istreambuf_iterator<char>(ir)), std::istreambuf_iterator<char>());
+    REQUIRE(text.find("define i32 @test(i32") != std::string::npos);
+
+    //the file is the only output, so failing to write it fails the compilation
+    config.outputMode = emitObj;
+    config.srcOutput = "no-such-dir/emit.o";
+    REQUIRE(RocCompiler::compileSource(source, "Emit.roc", config) == nullptr);
+    config.outputMode = emitIR;
+    config.srcOutput = "no-such-dir/emit.ll";
+    REQUIRE(RocCompiler::compileSource(source, "Emit.roc", config) == nullptr);
+}
+
+TEST_CASE("Compile memory mapped source", "[compileSource]") {
+    {
+        std::ofstream out("Mapped.roc");
+        out << "package main\n"
+               "fun test(a Int32) -> Int32 {\n"
+               "  ret a * 2\n"
+               "}\n";
+    }
+    auto source = SourceBuffer::fromFile("Mapped.roc");
+    REQUIRE(source != nullptr);
+    REQUIRE(source->getText().substr(0, 12) == "package main");
+    auto result = RocCompiler::compileSource(source, "Mapped.roc");
+    if (result) {
+        auto ref = (int (*)(int)) result->EE->getFunctionAddress("test");
+        REQUIRE(ref(21) == 42);
+    } else {
+        REQUIRE(false);
+    }
+    REQUIRE(SourceBuffer::fromFile("Missing.roc") == nullptr);
+}
+
+TEST_CASE("Resolve calls through the symbol index", "[symbolIndex]") {
+    std::string source = "package main\n"
+                         "fun f0(a Int32) -> Int32 {\n"
+                         "  ret a + 0\n"
+                         "}\n";
+    for (int i = 1; i < 200; i++) {
+        source += "fun f" + std::to_string(i) + "(a Int32) -> Int32 {\n"
+                  "  ret f" + std::to_string(i - 1) + "(a) + 1\n"
+                  "}\n";
+    }
+    auto result = RocCompiler::compileSource(source, "SymbolIndex.roc");
+    if (result) {
+        auto ref = (int (*)(int)) result->EE->getFunctionAddress("f199");
+        REQUIRE(ref(1) == 200);
+    } else {
+        REQUIRE(false);
+    }
+
+    Interner interner;
+    SymbolIndex symbolIndex(&interner);
+    REQUIRE(symbolIndex.find(moduleFunctionsTypeId, interner.intern("f0"), 1) == nullptr);
+    auto int32Type = TypeTable::int32Type();
+    REQUIRE(symbolIndex.findMethod(int32Type, roc::symbols::toStringName, 0)->getRealName() == "Any.toString.0");
+    REQUIRE(symbolIndex.findMethod(int32Type, roc::symbols::toStringName, 1) == nullptr);
+    REQUIRE(symbolIndex.findMethod(int32Type, interner.intern("missing"), 0) == nullptr);
+}
+
+TEST_CASE("Run MIR passes picked by config", "[mirPassManager]") {
+    Config config;
+    config.mirPasses = "constprop";
+    config.verifyMIR = true;
+    auto result = RocCompiler::compileSource("package main;\n"
+                                             "fun test(a Int32) -> Int32 {\n"
+                                             "  if 2 == 3 {\n"
+                                             "    ret a + 1\n"
+                                             "  }\n"
+                                             "  ret 2 + 3 * 4 - a\n"
+                                             "}", "MIRPasses.roc", config);
+    if (result) {
+        REQUIRE(result->foldedConstants == 2);
+        REQUIRE(result->eliminatedBlocks == 0);
+        std::vector<std::string> passes;
+        for (auto& passStatistics: result->mirPassStatistics) {
+            passes.push_back(passStatistics.name);
+        }
+        REQUIRE(passes == std::vector<std::string>{"builtins", "labels", "cast", "heap", "cfg", "constprop"});
+        auto ref = (int (*)(int)) result->EE->getFunctionAddress("test");
+        REQUIRE(ref(5) == 9);
+    } else {
+        REQUIRE(false);
+    }
+
+    REQUIRE(MIRPassManager().isRegistered("dce"));
+    REQUIRE_THROWS(MIRPassManager().addPasses("devirt,escape"));
+}
+
+TEST_CASE("Report time of compiler phases", "[timeReport]") {
+    Config config;
+    config.timeReportJSON = "timeReport.json";
+    std::remove("timeReport.json");
+    auto result = RocCompiler::compileSource("package main;\n"
+                                             "fun test(a Int32) -> Int32 {\n"
+                                             "  ret a + 1\n"
+                                             "}", "TimeReport.roc", config);
+    if (result) {
+        std::map<std::string, int> depths;
+        for (auto& phase: result->compilePhases) {
+            REQUIRE(phase.wallMilliseconds >= 0);
+            depths[phase.name] = phase.depth;
+        }
+        REQUIRE(depths.at("lex and parse") == 0);
+        REQUIRE(depths.at("type resolver") == 0);
+        REQUIRE(depths.at("MIR passes") == 0);
+        REQUIRE(depths.at("cfg") == 1);
+        REQUIRE(depths.at("JIT engine") == 0);
+        std::ifstream json("timeReport.json");
+        std::string text((std::istreambuf_iterator<char>(json)), std::istreambuf_iterator<char>());
+        REQUIRE(text.rfind("{\"phases\": [{\"name\": \"load source\"", 0) == 0);
+    } else {
+        REQUIRE(false);
+    }
+}
+
+TEST_CASE("Write Chrome trace of compilation", "[trace]") {
+    Config config;
+    config.traceFile = "trace.json";
+    std::remove("trace.json");
+    auto result = RocCompiler::compileSource("package main;\n"
+                                             "fun test(a Int32) -> Int32 {\n"
+                                             "  ret a + 1\n"
+                                             "}", "Trace.roc", config);
+    REQUIRE(result != nullptr);
+    std::ifstream json("trace.json");
+    std::string text((std::istreambuf_iterator<char>(json)), std::istreambuf_iterator<char>());
+    REQUIRE(text.find("\"traceEvents\"") != std::string::npos);
+    REQUIRE(text.find("\"name\":\"type resolver\"") != std::string::npos);
+    REQUIRE(text.find("\"detail\":\"test\"") != std::string::npos);
+    REQUIRE(text.find("\"name\":\"RunPass\"") != std::string::npos);
+}
+
+TEST_CASE("Virtual tables are constant globals", "[staticVTables]") {
+    Config config;
+    config.outputMode = emitIR;
+    config.srcOutput = "vtables.ll";
+    auto result = RocCompiler::compileSource("package main\n"
+                                             "fun test(a Int32) {\n"
+                                             "  println(a.toString())\n"
+                                             "}\n", "VTables.roc", config);
+    REQUIRE(result != nullptr);
+    std::ifstream ir("vtables.ll");
+    std::string text((std::istreambuf_iterator<char>(ir)), std::istreambuf_iterator<char>());
+    REQUIRE(text.find("@Int32.vtable = internal constant [4 x i64]") != std::string::npos);
+    REQUIRE(text.find("@StringRaw.vtable = internal constant [4 x i64]") != std::string::npos);
+    REQUIRE(text.find("vtable.init") == std::string::npos);
+    REQUIRE(text.find("myVTableFactory") == std::string::npos);
+}
+
+TEST_CASE("Boxed Int32 values come from the immortal cache", "[int32Cache]") {
+    Config config;
+    config.outputMode = emitIR;
+    config.srcOutput = "int32cache.ll";
+    auto result = RocCompiler::compileSource("package main\n"
+                                             "fun test(a Int32) {\n"
+                                             "  println(a.toString())\n"
+                                             "}\n", "Int32Cache.roc", config);
+    REQUIRE(result != nullptr);
+    std::ifstream ir("int32cache.ll");
+    std::string text((std::istreambuf_iterator<char>(ir)), std::istreambuf_iterator<char>());
+    REQUIRE(text.find("@Int32.cache = internal constant [1152 x") != std::string::npos);
+    REQUIRE(text.find("int32-cached") != std::string::npos);
+
+    //cached and freshly boxed values are both printed by the generated code
+    result = RocCompiler::compileSource("package main\n"
+                                        "fun test(a Int32) {\n"
+                                        "  println(a.toString())\n"
+                                        "}\n", "Int32Cache.roc");
+    REQUIRE(result != nullptr);
+    auto test = (void (*)(int)) result->EE->getFunctionAddress("test");
+    test(7);
+    test(70000);
+
+    config.int32CacheMin = 1;
+    config.int32CacheMax = 0;
+    config.srcOutput = "int32nocache.ll";
+    result = RocCompiler::compileSource("package main\n"
+                                        "fun test(a Int32) {\n"
+                                        "  println(a.toString())\n"
+                                        "}\n", "Int32Cache.roc", config);
+    REQUIRE(result != nullptr);
+    std::ifstream noCacheIR("int32nocache.ll");
+    text = std::string((std::istreambuf_iterator<char>(noCacheIR)), std::istreambuf_iterator<char>());
+    REQUIRE(text.find("Int32.cache") == std::string::npos);
+
+    //ranges wider than the limit are not cached instead of building a huge table
+    config.int32CacheMin = INT32_MIN;
+    config.int32CacheMax = INT32_MAX;
+    config.srcOutput = "int32widecache.ll";
+    result = RocCompiler::compileSource("package main\n"
+                                        "fun test(a Int32) {\n"
+                                        "  println(a.toString())\n"
+                                        "}\n", "Int32Cache.roc", config);
+    REQUIRE(result != nullptr);
+    std::ifstream wideCacheIR("int32widecache.ll");
+    text = std::string((std::istreambuf_iterator<char>(wideCacheIR)), std::istreambuf_iterator<char>());
+    REQUIRE(text.find("Int32.cache") == std::string::npos);
+}
+
+TEST_CASE("Flush runtime output from Roc", "[output]") {
+    auto result = RocCompiler::compileSource("package main\n"
+                                             "fun test() {\n"
+                                             "  flush()\n"
+                                             "}\n", "Flush.roc");
+    REQUIRE(result != nullptr);
+    auto test = (void (*)()) result->EE->getFunctionAddress("test");
+    REQUIRE(test != nullptr);
+    test();
+}
+
+TEST_CASE("Strings of generated Int32 toString are released", "[allocator]") {
+    auto result = RocCompiler::compileSource("package main\n"
+                                             "fun test(a Int32) {\n"
+                                             "  println(a.toString())\n"
+                                             "}\n", "Int32ToString.roc");
+    REQUIRE(result != nullptr);
+    auto test = (void (*)(int)) result->EE->getFunctionAddress("test");
+    REQUIRE(test != nullptr);
+    test(-1); //lazily compiled code and first output are not counted
+    auto liveBlocks = rocLiveSmallBlocks();
+    for (int i = 0; i < 1000; i++) {
+        test(i * 7919);
+    }
+    rocFlush();
+    REQUIRE(rocLiveSmallBlocks() == liveBlocks);
+}
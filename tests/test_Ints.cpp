@@ -271,4 +271,88 @@ TEST_CASE("Comparing ints 5", "[comparingInts5]") {
     } else {
         REQUIRE(false);
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Devirtualize Int32 toString", "[devirtualizeInt32ToString]") {
+    auto result = RocCompiler::compile("package main;\n"
+                                       "fun test(a Int32) {\n"
+                                       "  println(a.toString())\n"
+                                       "}", "Test1");
+    if (result) {
+        REQUIRE(result->devirtualizedCalls == 1);
+        auto ref = (void (*)(int)) result->EE->getFunctionAddress("test");
+        ref(42);
+    } else {
+        REQUIRE(false);
+    }
+}
+
+TEST_CASE("Optimized Ints 1", "[optimizedInts1]") {
+    Config config;
+    config.optimizationLevel = 2;
+    auto result = RocCompiler::compile("package main;\n"
+                                       "fun add(a Int32, b Int32) -> Int32 {\n"
+                                       "  ret a + b\n"
+                                       "}\n"
+                                       "fun test(a Int32) -> Int32 {\n"
+                                       "  ret add(a, 2) * 3\n"
+                                       "}", "Test1", config);
+    if (result) {
+        auto ref = (int (*)(int)) result->EE->getFunctionAddress("test");
+        REQUIRE(ref(5) == 21);
+    } else {
+        REQUIRE(false);
+    }
+}
+
+TEST_CASE("Native target Ints 1", "[nativeTargetInts1]") {
+    Config config;
+    config.optimizationLevel = 2;
+    config.targetCpu = "native";
+    auto result = RocCompiler::compile("package main;\n"
+                                       "fun test(a Int32) -> Int32 {\n"
+                                       "  ret a * 3\n"
+                                       "}", "Test1", config);
+    if (result) {
+        REQUIRE(result->targetCpu != "native");
+        auto ref = (int (*)(int)) result->EE->getFunctionAddress("test");
+        REQUIRE(ref(5) == 15);
+    } else {
+        REQUIRE(false);
+    }
+}
+
+TEST_CASE("Constant propagation Ints 1", "[constantPropagationInts1]") {
+    auto result = RocCompiler::compile("package main;\n"
+                                       "fun test(a Int32) -> Int32 {\n"
+                                       "  if 2 == 3 {\n"
+                                       "    ret a + 1\n"
+                                       "  }\n"
+                                       "  ret 2 + 3 * 4 - a\n"
+                                       "}", "Test1");
+    if (result) {
+        REQUIRE(result->foldedConstants == 2);
+        REQUIRE(result->eliminatedBlocks == 1);
+        auto ref = (int (*)(int)) result->EE->getFunctionAddress("test");
+        REQUIRE(ref(4) == 10);
+    } else {
+        REQUIRE(false);
+    }
+}
+
+TEST_CASE("If without return", "[ifWithoutReturn]") {
+    auto result = RocCompiler::compile("package main;\n"
+                                       "fun test(a Int32) -> Int32 {\n"
+                                       "  if a == 2 {\n"
+                                       "    println(a.toString())\n"
+                                       "  }\n"
+                                       "  ret a * 2\n"
+                                       "}", "Test1");
+    if (result) {
+        auto ref = (int (*)(int)) result->EE->getFunctionAddress("test");
+        REQUIRE(ref(2) == 4);
+        REQUIRE(ref(3) == 6);
+    } else {
+        REQUIRE(false);
+    }
+}
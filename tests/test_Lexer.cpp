@@ -0,0 +1,81 @@
+#include "Catch.h"
+#include "../parser/Lexer.h"
+#include <chrono>
+
+TEST_CASE("Keywords", "[lexerKeywords]") {
+    Lexer lexer(std::string("fun for met while ret var val in is break continue if else lam or and import true false "
+                            "struct trait Null varargs package funny fo whiles Package retx"), "Keywords.roc");
+    std::vector<ElementType> expected = {
+            ElementType::funKeyword, ElementType::forKeyword, ElementType::metKeyword, ElementType::whileKeyword,
+            ElementType::returnKeyword, ElementType::varKeyword, ElementType::valKeyword, ElementType::inKeyword,
+            ElementType::isKeyword, ElementType::breakKeyword, ElementType::continueKeyword, ElementType::ifKeyword,
+            ElementType::elseKeyword, ElementType::lamKeyword, ElementType::orKeyword, ElementType::andKeyword,
+            ElementType::importKeyword, ElementType::trueKeyword, ElementType::falseKeyword,
+            ElementType::structKeyword, ElementType::interfaceKeyword, ElementType::nullToken,
+            ElementType::varargsKeyword, ElementType::packageKeyword,
+            ElementType::literal, ElementType::literal, ElementType::literal, ElementType::literal,
+            ElementType::literal
+    };
+    for (auto elementType : expected) {
+        REQUIRE(lexer.nextToken()->getTokenType() == elementType);
+    }
+    REQUIRE(lexer.nextToken()->getTokenType() == ElementType::eofToken);
+}
+
+TEST_CASE("Long runs", "[lexerRuns]") {
+    std::string identifier(70, 'a');
+    identifier += "_1\t?";
+    std::string spaces(40, ' ');
+    Lexer lexer(identifier + spaces + "12345678901234567890 1.5e-3" + spaces + "\"" + spaces + "x\"", "Runs.roc");
+
+    auto literal = lexer.nextToken();
+    REQUIRE(literal->getText() == identifier);
+    REQUIRE(literal->getStartOffset() == 0);
+
+    auto number = lexer.nextToken();
+    REQUIRE(number->getTokenType() == ElementType::literal);
+    REQUIRE(number->getStartOffset() == identifier.size() + spaces.size());
+    REQUIRE(lexer.nextToken()->getText() == "1.5e-3");
+
+    REQUIRE(lexer.nextToken()->getTokenType() == ElementType::quotationMark);
+    auto body = lexer.nextStringBody();
+    REQUIRE(body->getText() == spaces + "x");
+    REQUIRE(lexer.nextToken()->getTokenType() == ElementType::quotationMark);
+    REQUIRE(lexer.nextToken()->getTokenType() == ElementType::eofToken);
+}
+
+TEST_CASE("Lexer throughput", "[.][lexerBenchmark]") {
+    //compare figures of Release builds only i.e. RocTests "[lexerBenchmark]"
+    std::string source = "package main\n";
+    for (int i = 0; i < 100000; i++) {
+        source += "fun test" + std::to_string(i) + "(a Int32, b Int32) -> Int32 {\n"
+                  "  var value = a + b * 2\n"
+                  "  if value >= 10 and b != 0 { ret value } else { ret continueWith(value, false) }\n"
+                  "}\n";
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Lexer lexer(std::move(source), "Benchmark.roc");
+    size_t tokens = 0;
+    while (lexer.nextTokenWithWS()->getTokenType() != ElementType::eofToken) {
+        tokens++;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << "lexed " << tokens << " tokens in " << elapsed.count() << "s, "
+              << (size_t) (tokens / elapsed.count()) << " tokens/s" << std::endl;
+    REQUIRE(tokens > 0);
+}
+
+TEST_CASE("Identifier symbols", "[lexerSymbols]") {
+    Lexer lexer(std::string("foo bar foo Int32 println"), "Symbols.roc");
+    auto foo = (Literal*) lexer.nextToken();
+    auto bar = (Literal*) lexer.nextToken();
+    auto fooAgain = (Literal*) lexer.nextToken();
+    REQUIRE(foo->symbol == fooAgain->symbol);
+    REQUIRE(foo->symbol != bar->symbol);
+    REQUIRE(lexer.interner->getName(bar->symbol) == "bar");
+    REQUIRE(((Literal*) lexer.nextToken())->symbol == roc::symbols::int32Name);
+    REQUIRE(((Literal*) lexer.nextToken())->symbol == roc::symbols::printlnName);
+    REQUIRE(lexer.interner->size() == roc::symbols::wellKnownCount + 2);
+}
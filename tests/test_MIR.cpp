@@ -0,0 +1,75 @@
+#include "Catch.h"
+#include "../mir/MIR.h"
+#include "../parser/Arena.h"
+#include "../passes/ControlFlowPass.h"
+
+static MIRIf* newIf(std::vector<MIRValue*> values) {
+    auto condition = new MIRInt32Eq(new MIRLocalVariableAccess("a", 0, TypeTable::int32Type()), new MIRConstantInt(1));
+    return new MIRIf(new MIRCondition(condition), new MIRBlock("block", std::move(values)));
+}
+
+TEST_CASE("Control flow graph", "[controlFlowGraph]") {
+    Arena arena;
+    Arena::Scope arenaScope(&arena);
+
+    //if a == 1 { ret 1 }; if a == 1 { 2 }; ret 3
+    auto body = new MIRBlock("entry", {
+            newIf({new MIRReturnValue(new MIRConstantInt(1))}),
+            newIf({new MIRConstantInt(2)}),
+            new MIRReturnValue(new MIRConstantInt(3))
+    });
+    auto function = new MIRFunction("test", {}, new MIRTypeDecl(TypeTable::int32Type()), body);
+
+    ControlFlowGraphBuilder builder;
+    function->accept(&builder);
+
+    auto& blocks = function->blocks;
+    REQUIRE(blocks.size() == 5);
+    auto entry = blocks[0], firstThen = blocks[1], firstEnd = blocks[2], secondThen = blocks[3], secondEnd = blocks[4];
+    REQUIRE(entry->successors == std::vector<MIRBasicBlock*>{firstThen, firstEnd});
+    REQUIRE(firstThen->successors.empty());
+    REQUIRE(secondThen->successors == std::vector<MIRBasicBlock*>{secondEnd});
+    REQUIRE(secondEnd->predecessors.size() == 2);
+
+    REQUIRE(secondEnd->immediateDominator == firstEnd);
+    REQUIRE(entry->dominates(secondEnd));
+    REQUIRE(firstEnd->dominates(secondThen));
+    REQUIRE_FALSE(firstThen->dominates(firstEnd));
+    REQUIRE_FALSE(secondThen->dominates(secondEnd));
+
+    DeadCodeElimination deadCodeElimination;
+    function->accept(&deadCodeElimination);
+    REQUIRE(deadCodeElimination.eliminatedValues == 1);
+    REQUIRE(secondThen->values.empty());
+}
+
+TEST_CASE("Interned types", "[internedTypes]") {
+    REQUIRE(TypeTable::int32Type() == TypeTable::int32Type());
+    REQUIRE(TypeTable::rawStringType(3) == TypeTable::rawStringType(3));
+    REQUIRE(TypeTable::rawStringType(3) != TypeTable::rawStringType(4));
+    REQUIRE(TypeTable::int32Type()->getPtrType() == TypeTable::ptrType(TypeTable::int32Type()));
+    REQUIRE(TypeTable::arrayType(TypeTable::int32Type()) != TypeTable::arrayType(TypeTable::int64Type()));
+    REQUIRE(TypeTable::int32Type()->getMatchingTraits() == std::vector<RocType*>{TypeTable::anyType()});
+
+    Arena arena;
+    Arena::Scope arenaScope(&arena);
+    auto wrapper = new MIRToWrapper(new MIRConstantInt(1));
+    REQUIRE(wrapper->getType() == TypeTable::wrapperType(TypeTable::int32Type()));
+
+    REQUIRE(TypeTable::anyType()->matches(TypeTable::int32Type()));
+    REQUIRE(TypeTable::rawStringType(-1)->matches(TypeTable::rawStringType(5)));
+    REQUIRE_FALSE(TypeTable::int32Type()->matches(TypeTable::boolType()));
+    REQUIRE(TypeTable::boolType()->typeEnum == TypeEnum::boolType);
+}
+
+TEST_CASE("Composite types are owned by the active type table", "[internedTypes]") {
+    auto shared = TypeTable::rawStringType(7);
+    {
+        TypeTable typeTable;
+        TypeTable::Scope typeTableScope(&typeTable);
+        REQUIRE(TypeTable::rawStringType(7) == TypeTable::rawStringType(7));
+        REQUIRE(TypeTable::rawStringType(7) != shared);
+        REQUIRE(TypeTable::int32Type()->getPtrType() == TypeTable::ptrType(TypeTable::int32Type()));
+    }
+    REQUIRE(TypeTable::rawStringType(7) == shared);
+}
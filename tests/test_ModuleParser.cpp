@@ -5,6 +5,7 @@
 #include "Catch.h"
 #include "../parser/Parser.h"
 #include <memory>
+#include <chrono>
 #include "ExprHandler.h"
 
 #ifdef SANDBOX_DIR
@@ -83,4 +84,44 @@ TEST_CASE("expected arrow 1", "[expectedArrow1]") {
     ModuleParser moduleParser(pc.get());
     moduleParser.parse();
     REQUIRE(!moduleParser.syntaxExceptions.empty());
-}
\ No newline at end of file
+}
+
+TEST_CASE("module outlives lexer", "[arena]") {
+    std::shared_ptr<ModuleDeclaration> module;
+    {
+        Lexer lexer(std::string("package main\nfun test(a Int32) -> Int32 {\n  ret a\n}\n"), "Arena.roc");
+        auto pc = std::make_unique<ParseContext>(&lexer);
+        ModuleParser moduleParser(pc.get());
+        moduleParser.parse();
+        REQUIRE(moduleParser.syntaxExceptions.empty());
+        module = pc->moduleDeclarations.back();
+    }
+    REQUIRE(module->arena->allocatedBlocks() == 1);
+    REQUIRE(module->functions.front()->getName()->getText() == "test");
+}
+
+TEST_CASE("Parser throughput", "[.][parserBenchmark]") {
+    std::string source = "package main\n";
+    for (int i = 0; i < 20000; i++) {
+        source += "fun test" + std::to_string(i) + "(argument Int32, factor Int32) -> Int32 {\n"
+                  "    var accumulated = argument + factor * 2\n"
+                  "    if accumulated >= 10 {\n"
+                  "        println(\"accumulated value is large enough\")\n"
+                  "        ret accumulated\n"
+                  "    }\n"
+                  "    ret accumulated - 1\n"
+                  "}\n";
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        Lexer lexer(std::move(source), "Benchmark.roc");
+        auto pc = std::make_unique<ParseContext>(&lexer);
+        ModuleParser moduleParser(pc.get());
+        moduleParser.parse();
+        REQUIRE(moduleParser.syntaxExceptions.empty());
+        std::cout << "arena blocks: " << lexer.arena->allocatedBlocks() << std::endl;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "parsed and released 20000 functions in " << elapsed.count() << "s" << std::endl;
+}
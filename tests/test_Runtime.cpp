@@ -0,0 +1,202 @@
+#include "Catch.h"
+#include "../linking/API.h"
+#include "../linking/Allocator.h"
+#include "../linking/Format.h"
+#include "../linking/Output.h"
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <set>
+#include <string>
+
+#ifdef _WIN32
+#include <io.h>
+#define dup _dup
+#define dup2 _dup2
+#define fileno _fileno
+#define close _close
+#else
+#include <unistd.h>
+#endif
+
+/**
+ * Redirects fd 1 to a temporary file while in scope
+ */
+class CapturedOutput {
+private:
+    FILE* file;
+    int savedOutput;
+
+public:
+    CapturedOutput() : file(std::tmpfile()) {
+        rocFlush();
+        std::fflush(stdout);
+        savedOutput = dup(1);
+        dup2(fileno(file), 1);
+    }
+
+    ~CapturedOutput() {
+        rocFlush();
+        dup2(savedOutput, 1);
+        close(savedOutput);
+        std::fclose(file);
+    }
+
+    std::string text() {
+        std::string result;
+        std::fseek(file, 0, SEEK_SET);
+        char buffer[256];
+        size_t read;
+        while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+            result.append(buffer, read);
+        }
+        return result;
+    }
+};
+
+TEST_CASE("Size-class allocator", "[allocator]") {
+    std::set<void*> blocks;
+    bool aligned = true;
+    for (int i = 0; i < 1000; i++) {
+        auto block = rocAlloc(sizeof(Int32RType));
+        aligned = aligned && ((uintptr_t) block) % ROC_SIZE_CLASS_STEP == 0;
+        blocks.insert(block);
+    }
+    REQUIRE(aligned);
+    REQUIRE(blocks.size() == 1000);
+    for (auto block: blocks) {
+        rocFree(block, sizeof(Int32RType));
+    }
+    //freed blocks are reused by the same size class
+    auto reused = rocAlloc(sizeof(Int32RType));
+    REQUIRE(blocks.count(reused) == 1);
+    rocFree(reused, sizeof(Int32RType));
+
+    auto large = (char*) rocAlloc(ROC_MAX_SMALL_SIZE + 1);
+    large[ROC_MAX_SMALL_SIZE] = 1;
+    rocFree(large, ROC_MAX_SMALL_SIZE + 1);
+
+    auto string = (StringRawRType*) myInt32ToString(-1234, 0);
+    REQUIRE(std::string(string->data, string->length) == "-1234");
+    REQUIRE(string->refC == 1);
+    REQUIRE(string->data == (char*) (string + 1));
+    myDecr(string);
+    //header and chars are released as one block
+    auto released = rocAlloc(ROC_MAX_SMALL_SIZE);
+    REQUIRE(released == (void*) string);
+    rocFree(released, ROC_MAX_SMALL_SIZE);
+}
+
+TEST_CASE("Reference counting skips immortal objects", "[int32Cache]") {
+    Int32RType cached{};
+    cached.typeId = 4;
+    cached.refC = ROC_IMMORTAL_REFC;
+    cached.value = 7;
+    myDecr(&cached);
+    REQUIRE(cached.refC == ROC_IMMORTAL_REFC);
+    REQUIRE(cached.value == 7);
+}
+
+TEST_CASE("Buffered runtime output", "[output]") {
+    CapturedOutput output;
+    rocSetOutputBuffering(ROC_OUTPUT_FULLY_BUFFERED, 16);
+    rocWrite("0123456789", 10);
+    REQUIRE(output.text().empty());
+    //does not fit, the buffer is written first
+    rocWrite("abcdefghij", 10);
+    REQUIRE(output.text() == "0123456789");
+    rocFlush();
+    REQUIRE(output.text() == "0123456789abcdefghij");
+    //bigger than the buffer, goes straight to fd 1
+    rocWrite("0123456789abcdefghij", 20);
+    REQUIRE(output.text() == "0123456789abcdefghij0123456789abcdefghij");
+
+    rocSetOutputBuffering(ROC_OUTPUT_LINE_BUFFERED, ROC_OUTPUT_BUFFER_SIZE);
+    auto string = (StringRawRType*) myInt32ToString(42, 0);
+    ROC_PTR vTable[ROC_VTABLE_SIZE] = {(ROC_PTR) myStringRawRTypeToString}; //toString returns the string itself
+    string->vTable = (ROC_PTR) vTable;
+    output.text();
+    myPrint(1, string);
+    REQUIRE(output.text() == "0123456789abcdefghij0123456789abcdefghij");
+    myPrintln(1, string);
+    REQUIRE(output.text() == "0123456789abcdefghij0123456789abcdefghij4242 \n");
+    myDecr(string);
+
+    rocSetOutputBuffering(ROC_OUTPUT_UNBUFFERED, 0);
+    rocWrite("x", 1);
+    REQUIRE(output.text() == "0123456789abcdefghij0123456789abcdefghij4242 \nx");
+    rocSetOutputBuffering(ROC_OUTPUT_FULLY_BUFFERED, ROC_OUTPUT_BUFFER_SIZE);
+}
+
+TEST_CASE("Integer and float formatting", "[format]") {
+    char buffer[32];
+    for (int n: {0, 7, -7, 9, 10, 99, 100, -100, 12345, 999999, 1000000, INT_MAX, INT_MIN}) {
+        auto length = rocFormatInt32(buffer, n);
+        REQUIRE(std::string(buffer, length) == std::to_string(n));
+    }
+    for (long long n: {10000000000LL, -1234567890123LL, LLONG_MAX, LLONG_MIN}) {
+        auto length = rocFormatInt64(buffer, n);
+        REQUIRE(std::string(buffer, length) == std::to_string(n));
+    }
+    for (double n: {0.5, -1.25, 0.1, 1e300, -2.2250738585072014e-308}) {
+        auto length = rocFormatFloat64(buffer, n);
+        REQUIRE(length <= ROC_FLOAT64_MAX_CHARS);
+        REQUIRE(std::strtod(std::string(buffer, length).c_str(), nullptr) == n);
+    }
+
+    auto string = (StringRawRType*) myInt32ToString(INT_MIN, 0);
+    REQUIRE(std::string(string->data) == "-2147483648");
+    myDecr(string);
+
+    CapturedOutput output;
+    rocSetOutputBuffering(ROC_OUTPUT_FULLY_BUFFERED, ROC_OUTPUT_BUFFER_SIZE);
+    Int32RType boxed{};
+    myInitInt32(&boxed, -42, 0); //written without toString, so the missing virtual table is never read
+    myPrintln(1, &boxed);
+    rocWriteInt64(LLONG_MIN);
+    rocWrite(" ", 1);
+    rocWriteFloat64(0.25);
+    rocFlush();
+    REQUIRE(output.text() == "-42 \n-9223372036854775808 0.25");
+}
+
+TEST_CASE("Throughput of 10M printed lines", "[.][outputBenchmark]") {
+    //run with stdout redirected i.e. RocTests "[outputBenchmark]" > /dev/null
+    auto string = (StringRawRType*) myInt32ToString(1234567, 0);
+    ROC_PTR vTable[ROC_VTABLE_SIZE] = {(ROC_PTR) myStringRawRTypeToString};
+    string->vTable = (ROC_PTR) vTable;
+    for (auto mode: {ROC_OUTPUT_FULLY_BUFFERED, ROC_OUTPUT_LINE_BUFFERED}) {
+        rocSetOutputBuffering(mode, ROC_OUTPUT_BUFFER_SIZE);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < 10000000; i++) {
+            myPrintln(1, string);
+        }
+        rocFlush();
+        auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cerr << (mode == ROC_OUTPUT_FULLY_BUFFERED ? "fully" : "line") << " buffered: " << seconds << " s, "
+                  << (long long) (10000000 / seconds) << " lines/s" << std::endl;
+    }
+    rocSetOutputBuffering(ROC_OUTPUT_FULLY_BUFFERED, ROC_OUTPUT_BUFFER_SIZE);
+    myDecr(string);
+}
+
+TEST_CASE("Throughput of 10M printed Int32 lines", "[.][outputBenchmark]") {
+    //boxed values are formatted straight into the output buffer, without a string object
+    Int32RType boxed{};
+    for (auto mode: {ROC_OUTPUT_FULLY_BUFFERED, ROC_OUTPUT_LINE_BUFFERED}) {
+        rocSetOutputBuffering(mode, ROC_OUTPUT_BUFFER_SIZE);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < 10000000; i++) {
+            myInitInt32(&boxed, i, 0);
+            myPrintln(1, &boxed);
+        }
+        rocFlush();
+        auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cerr << (mode == ROC_OUTPUT_FULLY_BUFFERED ? "fully" : "line") << " buffered: " << seconds << " s, "
+                  << (long long) (10000000 / seconds) << " lines/s" << std::endl;
+    }
+    rocSetOutputBuffering(ROC_OUTPUT_FULLY_BUFFERED, ROC_OUTPUT_BUFFER_SIZE);
+}